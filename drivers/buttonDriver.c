@@ -1,11 +1,43 @@
 /*
  * buttonDriver.c
  *
- *  This file implements all functionality of a button required. Currently only the initializer function is neccessary.
+ *  This file implements all functionality of a button required. The pin interrupt only starts the debounce time, the state is taken over
+ *  by the timer interrupt once the debounce time has passed. Neither interrupt occurs while the button is not touched.
  *
  */
 
 #include "buttonDriver.h"
+#include "launchpad.h"
+#include "../messageQueue.h"
+
+#define BTN_TIMER_COUNTS(ms)        (uint16_t)((ms) * (LAUNCHPAD_TIMESTAMP_FREQUENCY / 1000))   //Converts milliseconds into counts of TimerA0
+
+typedef enum {                                                                  //Defines the states of the debounce state machine
+    BUTTONSTATE_RELEASED,                                                       //Waiting for the pin to go low
+    BUTTONSTATE_DEBOUNCE_PRESS,                                                 //The pin went low, waiting for it to be stable
+    BUTTONSTATE_PRESSED,                                                        //Waiting for the pin to go high, the timer counts the time held
+    BUTTONSTATE_DEBOUNCE_RELEASE                                                //The pin went high, waiting for it to be stable
+} ButtonState_t;
+
+static volatile ButtonState_t gButtonState = BUTTONSTATE_RELEASED;              //Current state of the debounce state machine
+static uint8_t gHoldSteps = 0;                                                  //Number of hold steps since the press
+static MessageQueue_t gEventQueue;                                              //Events posted by the interrupts for the waiting threads
+static ButtonEvent_t gEventQueueBuffer[BTN_EVENT_QUEUE_SIZE];                   //Buffer of the event queue
+
+/**
+ * Waits for the next edge of the pin. The edge is selected by the level the pin is expected to change from.
+ */
+static void buttonDriver_waitForEdge(unsigned char pressed);
+
+/**
+ * Starts the timer to interrupt after the specified number of milliseconds.
+ */
+static void buttonDriver_startTimer(uint16_t time);
+
+/**
+ * Posts an event to the waiting threads.
+ */
+static void buttonDriver_post(ButtonEvent_t event);
 
 /**
  * Initializes the button 1.
@@ -14,4 +46,122 @@ void buttonDriver_init(void) {
     BTN_PORT_REN |= BTN_SHIFT;              //Enable internal pull-up/down resistors
     BTN_PORT_OUT |= BTN_SHIFT;              //Select pull-up mode
     BTN_PORT_DIR &= ~BTN_SHIFT;             //Button pin to input
+    messageQueue_init(&gEventQueue, gEventQueueBuffer, sizeof(ButtonEvent_t), BTN_EVENT_QUEUE_SIZE);
+    gButtonState = BUTTONSTATE_RELEASED;
+    buttonDriver_waitForEdge(0);
+}
+
+/**
+ * Blocks the calling thread until the next event of the button is posted by an interrupt.
+ */
+ButtonEvent_t buttonDriver_waitEvent(void) {
+    ButtonEvent_t event;
+    messageQueue_receive(&gEventQueue, &event);
+    return event;
+}
+
+/**
+ * Handles the debounce time and the time a button is held. After the debounce time the pin is read: if it has the new level, the change is posted,
+ * otherwise it was a bounce and the previous state is restored. While the button is held, the timer interrupts every BTN_HOLD_STEP_TIME until
+ * the long press has been posted. A bounce of the release continues with the remaining hold steps, the step cut off by the bounce starts over.
+ */
+unsigned char buttonDriver_timerInterrupt(void) {
+    unsigned char pressed = (BTN_STATE) == 0;                                   //The button pulls the pin to ground
+    unsigned char posted = 0;
+
+    switch(gButtonState) {
+    case BUTTONSTATE_DEBOUNCE_PRESS:
+        if(pressed) {
+            buttonDriver_post(BUTTON_EVENT_PRESS);
+            posted = 1;
+            gHoldSteps = 0;
+            gButtonState = BUTTONSTATE_PRESSED;
+            buttonDriver_startTimer(BTN_HOLD_STEP_TIME);
+        } else {
+            gButtonState = BUTTONSTATE_RELEASED;
+            TA0CCTL1 &= ~CCIE;
+        }
+        buttonDriver_waitForEdge(pressed);
+        break;
+
+    case BUTTONSTATE_PRESSED:
+        if(++gHoldSteps == BTN_LONG_PRESS_TIME / BTN_HOLD_STEP_TIME) {
+            buttonDriver_post(BUTTON_EVENT_LONG_PRESS);
+            posted = 1;
+            TA0CCTL1 &= ~CCIE;
+        } else {
+            buttonDriver_startTimer(BTN_HOLD_STEP_TIME);
+        }
+        break;
+
+    case BUTTONSTATE_DEBOUNCE_RELEASE:
+        if(!pressed) {
+            buttonDriver_post(BUTTON_EVENT_RELEASE);
+            posted = 1;
+            gButtonState = BUTTONSTATE_RELEASED;
+            TA0CCTL1 &= ~CCIE;
+        } else {
+            gButtonState = BUTTONSTATE_PRESSED;
+            if(gHoldSteps < BTN_LONG_PRESS_TIME / BTN_HOLD_STEP_TIME) {       //The debounce time replaced the hold timer, restart it
+                buttonDriver_startTimer(BTN_HOLD_STEP_TIME);
+            } else {
+                TA0CCTL1 &= ~CCIE;
+            }
+        }
+        buttonDriver_waitForEdge(pressed);
+        break;
+
+    default:
+        TA0CCTL1 &= ~CCIE;
+        break;
+    }
+    return posted;
+}
+
+/**
+ * Waits for the edge away from the current level of the pin. If the pin has changed already while the interrupt was disabled,
+ * the interrupt flag is set by software, so the change does not get lost.
+ */
+static void buttonDriver_waitForEdge(unsigned char pressed) {
+    if(pressed) {
+        BTN_PORT_IES &= ~BTN_SHIFT;                                             //Rising edge on release
+    } else {
+        BTN_PORT_IES |= BTN_SHIFT;                                              //Falling edge on press
+    }
+    BTN_PORT_IFG &= ~BTN_SHIFT;                                                 //Changing the edge may set the flag
+    if(((BTN_STATE) == 0) != pressed) {
+        BTN_PORT_IFG |= BTN_SHIFT;
+    }
+    BTN_PORT_IE |= BTN_SHIFT;
+}
+
+/**
+ * Starts the timer to interrupt after the specified number of milliseconds. The compare register is set relative to the free running TimerA0.
+ */
+static void buttonDriver_startTimer(uint16_t time) {
+    TA0CCR1 = launchpad_getTimerCount() + BTN_TIMER_COUNTS(time);
+    TA0CCTL1 = CCIE;
+}
+
+/**
+ * Posts an event without blocking. If no thread has taken the previous events, the event is dropped.
+ */
+static void buttonDriver_post(ButtonEvent_t event) {
+    messageQueue_trySend(&gEventQueue, &event);
+}
+
+/**
+ * This interrupt occurs on an edge of the button pin. The pin interrupt is disabled until the debounce time has passed, so bouncing does not cause further interrupts.
+ */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma vector = PORT1_VECTOR
+#endif
+__interrupt void PORT1_ISR(void)
+{
+    if(BTN_PORT_IFG & BTN_SHIFT) {
+        BTN_PORT_IE &= ~BTN_SHIFT;
+        BTN_PORT_IFG &= ~BTN_SHIFT;
+        gButtonState = gButtonState == BUTTONSTATE_RELEASED ? BUTTONSTATE_DEBOUNCE_PRESS : BUTTONSTATE_DEBOUNCE_RELEASE;
+        buttonDriver_startTimer(BTN_DEBOUNCE_TIME);
+    }
 }
@@ -2,6 +2,8 @@
  * buttonDriver.h
  *
  *  This file defines the various properties of a button and also some functions via a define to reduce function calls.
+ *  The button is handled by interrupts. An edge of the pin starts the debounce time on the capture/compare register 1 of TimerA0
+ *  and the state of the button is only taken over after the pin is stable. Every change is posted as an event.
  *
  */
 
@@ -15,15 +17,38 @@
 #define BTN_PORT_IN                 P1IN                        //Button 1 In
 #define BTN_PORT_REN                P1REN                       //Button 1 Pullup/Pulldown
 #define BTN_PORT_OUT                P1OUT                       //Button 1 Out
+#define BTN_PORT_IE                 P1IE                        //Button 1 Interrupt Enable
+#define BTN_PORT_IES                P1IES                       //Button 1 Interrupt Edge Select
+#define BTN_PORT_IFG                P1IFG                       //Button 1 Interrupt Flag
 #define BTN_SHIFT                   (1 << BTN)                  //Button 1 Shift onto the Pin Bit
 
-#define BTN_DEBOUNCE_TIME           50                          //Time in milliseconds to sleep after a button press to reduce bounce
+#define BTN_DEBOUNCE_TIME           50                          //Time in milliseconds the pin has to be stable after an edge to take over the state
+#define BTN_HOLD_STEP_TIME          250                         //Time in milliseconds between two checks of a held button
+#define BTN_LONG_PRESS_TIME         1000                        //Time in milliseconds a button has to be held to post a long press
+#define BTN_EVENT_QUEUE_SIZE        4                           //Number of events that are kept until a thread takes them
 
 #define BTN_STATE                   BTN_PORT_IN & BTN_SHIFT     //Macro to check the current state of the button
 
+typedef enum {                                                  //Defines the events of the button
+    BUTTON_EVENT_PRESS,
+    BUTTON_EVENT_RELEASE,
+    BUTTON_EVENT_LONG_PRESS                                     //Posted once while the button is held for BTN_LONG_PRESS_TIME, before the release
+} ButtonEvent_t;
+
 /**
  * Initializes the button 1
  */
 void buttonDriver_init(void);
 
+/**
+ * Blocks the calling thread until the next event of the button occurs and returns it.
+ */
+ButtonEvent_t buttonDriver_waitEvent(void);
+
+/**
+ * Handles the debounce time of the button. This is called by the interrupt of the capture/compare register 1 of TimerA0.
+ * Returns 1 if an event has been posted, so the CPU has to leave low power mode.
+ */
+unsigned char buttonDriver_timerInterrupt(void);
+
 #endif /* DRIVERS_BUTTONDRIVER_H_ */
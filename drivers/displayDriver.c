@@ -5,7 +5,8 @@
  *
  */
 
-#include "DisplayDriver.h"
+#include "displayDriver.h"
+#include "temperatureConverter.h"
 
 //Defines some display constants to displayed in certain segments.
 #define NEGATIVE_POS        101
@@ -13,7 +14,18 @@
 #define UNIT_POS            103
 #define DECIMAL_POS         104
 
-//Defines all currently required symbols. Note: Not every symbol is compatible with every segment.
+//Defines the index of every LCD memory register owned by the driver in a frame.
+#define FRAME_DIGIT_1       0
+#define FRAME_DIGIT_2       1
+#define FRAME_DIGIT_3       2
+#define FRAME_DIGIT_4       3
+#define FRAME_NEGATIVE      4
+#define FRAME_DECIMAL       5
+#define FRAME_DEGREE        6
+#define FRAME_UNIT          7
+#define FRAME_SIZE          8
+
+//Defines all currently required symbols. Note: Not every symbol is compatible with every segment. The digits have to be the first symbols, so a digit is its own symbol.
 typedef enum {
     SYMBOL_0,
     SYMBOL_1,
@@ -99,15 +111,29 @@ static uint8_t symbolTable[39] = {
                    0x01
 };
 
+//Defines the LCD memory registers of a frame. Note: These have to be in the same order as the FRAME_ indices.
+static volatile uint8_t* const frameRegisters[FRAME_SIZE] = {
+                   &LCDM10,
+                   &LCDM6,
+                   &LCDM4,
+                   &LCDM19,
+                   &LCDM11,
+                   &LCDM5,
+                   &LCDM16,
+                   &LCDM8
+};
+
+static uint8_t gShadowFrame[FRAME_SIZE];                    //Copy of the frame currently shown on the LCD
+
 /**
- * Displays a single symbol on the specified segment index.
+ * Adds a single symbol on the specified segment index to a frame.
  */
-static void displayDriver_showSymbol(uint16_t segmentIndex, Symbol_t symbol);
+static void displayDriver_showSymbol(uint8_t* frame, uint16_t segmentIndex, Symbol_t symbol);
 
 /**
- * Converts an integer to a Symbol. Any number exceeding 9 will be shown as 0.
+ * Writes the registers of a frame, which differ from the frame currently shown.
  */
-static Symbol_t displayDriver_resolveDigitToSymbol(uint8_t digit);
+static void displayDriver_updateFrame(const uint8_t* frame);
 
 /**
  * Converts a unit to a symbol.
@@ -131,99 +157,105 @@ void displayDriver_init(void){
     LCDCCTL0 |= LCDSON;
     LCDCCTL0 |= LCDON;
 
+    displayDriver_clear();
+}
+
+/**
+ * Clears the whole LCD memory and the copy of the frame currently shown.
+ */
+void displayDriver_clear(void){
+    unsigned int i = 0;
     DISPLAY_CLEAR;
+    for(i = 0; i < FRAME_SIZE; i++){
+        gShadowFrame[i] = 0;
+    }
 }
 
 /**
- * Displays a single symbol on the specified segment index.
+ * Adds a single symbol on the specified segment index to a frame.
  */
-static void displayDriver_showSymbol(uint16_t segmentIndex, Symbol_t symbol){
+static void displayDriver_showSymbol(uint8_t* frame, uint16_t segmentIndex, Symbol_t symbol){
 
     uint8_t digitCode = symbolTable[symbol];                //Resolve symbol to symbol code
 
     switch(segmentIndex){
         case 1:
-            LCDM10 = digitCode;
+            frame[FRAME_DIGIT_1] = digitCode;
             break;
         case 2:
-            LCDM6 = digitCode;
+            frame[FRAME_DIGIT_2] = digitCode;
             break;
         case 3:
-            LCDM4 = digitCode;
+            frame[FRAME_DIGIT_3] = digitCode;
             break;
         case 4:
-            LCDM19 = digitCode;
+            frame[FRAME_DIGIT_4] = digitCode;
             break;
         case DECIMAL_POS:
-            LCDM5 |= digitCode;
+            frame[FRAME_DECIMAL] = digitCode;
             break;
         case NEGATIVE_POS:
-            LCDM11 |= digitCode;
+            frame[FRAME_NEGATIVE] = digitCode;
             break;
         case DEGREE_POS:
-            LCDM16 = digitCode;
+            frame[FRAME_DEGREE] = digitCode;
             break;
         case UNIT_POS:
-            LCDM8 = digitCode;
+            frame[FRAME_UNIT] = digitCode;
             break;
         default:
             break;
     }
 }
 
+/**
+ * Writes the registers of a frame, which differ from the frame currently shown. An unchanged temperature does not write the LCD memory at all
+ * and segments that stay on are never switched off in between, so the display does not flicker.
+ */
+static void displayDriver_updateFrame(const uint8_t* frame){
+    unsigned int i = 0;
+    for(i = 0; i < FRAME_SIZE; i++){
+        if(frame[i] != gShadowFrame[i]){
+            *frameRegisters[i] = frame[i];
+            gShadowFrame[i] = frame[i];
+        }
+    }
+}
+
 /**
  * Display a temperature of specified unit on the LCD display. The temperature has one decimal place multiplied by 10 (20,1C = 201 here) and can range
  * from -9999 to +9999 (= -999.9 to +999.9). Any overflowing places will be truncated and not displayed.
  */
 void displayDriver_showTemperature(Temperature_t temperature, TemperatureUnit_t unit){
-    DISPLAY_CLEAR;                                                                          //Clear display initially
+    TemperatureDigits_t digits;
+    temperatureConverter_fromTemperature(temperature, &digits);
+    displayDriver_showDigits(&digits, unit);
+}
+
+/**
+ * Display the digits of a temperature of specified unit on the LCD display. Every nibble of the BCD digits is a symbol,
+ * so no division or conversion is required.
+ */
+void displayDriver_showDigits(const TemperatureDigits_t* digits, TemperatureUnit_t unit){
+    uint8_t frame[FRAME_SIZE] = {0};                                                        //Compose the new frame from an empty one
+    uint16_t bcd = digits->bcd;
 
-    if(temperature < 0) {                                                                   //If temperature is negative, show negative symbol and invert temperature
-        temperature = -temperature;
-        displayDriver_showSymbol(NEGATIVE_POS, SYMBOL_NEGATIVE);
+    if(digits->negative) {                                                                  //If temperature is negative, show negative symbol
+        displayDriver_showSymbol(frame, NEGATIVE_POS, SYMBOL_NEGATIVE);
     }
 
     unsigned int i = 0;
     for(i = 4; i > 0; i--){                                                                 //Iterate through 4 numbers displayable
-        displayDriver_showSymbol(i, displayDriver_resolveDigitToSymbol(temperature % 10));  //Show the rightmost digit
-        temperature /= 10;                                                                  //Truncate the temperature to remove the already displaying digit
-        if(temperature == 0){                                                               //If there are no digits left, stop
+        displayDriver_showSymbol(frame, i, (Symbol_t)(bcd & 0x0F));                         //Show the rightmost digit
+        bcd >>= 4;                                                                          //Remove the already displaying digit
+        if(bcd == 0){                                                                       //If there are no digits left, stop
             break;
         }
     }
-    displayDriver_showSymbol(DECIMAL_POS, SYMBOL_DECIMAL);                                  //Display decimal point
-    displayDriver_showSymbol(DEGREE_POS, SYMBOL_DEGREE);                                    //Display degree symbol
-    displayDriver_showSymbol(UNIT_POS, displayDriver_resolveUnitToSymbol(unit));            //Display unit symbol
-}
-
-/**
- * Converts an integer to a Symbol. Any number exceeding 9 will be shown as 0.
- */
-Symbol_t displayDriver_resolveDigitToSymbol(uint8_t digit) {
-    switch(digit) {
-    case 0:
-        return SYMBOL_0;
-    case 1:
-        return SYMBOL_1;
-    case 2:
-        return SYMBOL_2;
-    case 3:
-        return SYMBOL_3;
-    case 4:
-        return SYMBOL_4;
-    case 5:
-        return SYMBOL_5;
-    case 6:
-        return SYMBOL_6;
-    case 7:
-        return SYMBOL_7;
-    case 8:
-        return SYMBOL_8;
-    case 9:
-        return SYMBOL_9;
-    default:
-        return SYMBOL_0;
-    }
+    displayDriver_showSymbol(frame, DECIMAL_POS, SYMBOL_DECIMAL);                           //Display decimal point
+    displayDriver_showSymbol(frame, DEGREE_POS, SYMBOL_DEGREE);                             //Display degree symbol
+    displayDriver_showSymbol(frame, UNIT_POS, displayDriver_resolveUnitToSymbol(unit));     //Display unit symbol
+    displayDriver_updateFrame(frame);                                                       //Only write the registers that changed
 }
 
 /**
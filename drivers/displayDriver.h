@@ -19,15 +19,30 @@ typedef enum {                                                          //Define
     FAHRENHEIT
 } TemperatureUnit_t;
 
+typedef struct {                                                        //Defines the digits of a temperature with one decimal place
+    uint16_t bcd;                                                       //4 BCD digits of the magnitude, the lowest nibble holds the decimal place
+    uint8_t negative;
+} TemperatureDigits_t;
+
 /**
  * Initializes the various LCD segments required
  */
 void displayDriver_init(void);
 
+/**
+ * Clears the LCD display. The display has to be cleared with this function, so the driver knows what is currently shown.
+ */
+void displayDriver_clear(void);
+
 /**
  * Display a temperature of specified unit on the LCD display. The temperature has one decimal place multiplied by 10 (20,1C = 201 here) and can range
  * from -9999 to +9999 (= -999.9 to +999.9). Any overflowing places will be truncated and not displayed.
  */
 void displayDriver_showTemperature(Temperature_t temperature, TemperatureUnit_t unit);
 
+/**
+ * Display the digits of a temperature of specified unit on the LCD display. Leading zeros are not displayed.
+ */
+void displayDriver_showDigits(const TemperatureDigits_t* digits, TemperatureUnit_t unit);
+
 #endif /* DISPLAYDRIVER_H_ */
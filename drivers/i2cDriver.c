@@ -0,0 +1,230 @@
+/*
+ * i2cDriver.c
+ *
+ *  This file implements the interrupt driven transactions on the I2C module USCI_B0. Stop conditions of writes are generated by software,
+ *  so a write can be followed by a read with a repeated start condition. A read on its own is ended by the byte counter of the module. At the end of a transaction the interrupt starts the next
+ *  queued one right away, so the bus does not wait for a thread to be scheduled.
+ *
+ */
+
+#include "i2cDriver.h"
+#include "launchpad.h"
+#include "../trace.h"
+
+static I2CTransfer_t* gTransfer = NULL;                             //Transaction which is currently running on the bus, NULL if the bus is idle
+static I2CTransfer_t* gQueueHead = NULL;                            //First transaction waiting for the bus
+static I2CTransfer_t* gQueueTail = NULL;                            //Last transaction waiting for the bus
+static size_t gTxIndex;                                             //Index of the next byte to write
+static size_t gRxIndex;                                             //Index of the next byte to read
+static I2CStatus_t gResult;                                         //Result of the current transaction so far
+static uint32_t gTransferStart;                                     //System ticks at which the current transaction has been started
+
+/**
+ * Releases the module from the software reset and enables the required interrupts.
+ */
+static void i2cDriver_enable(void);
+
+/**
+ * Starts the first queued transaction, if there is any.
+ */
+static void i2cDriver_startNext(void);
+
+/**
+ * Sends a start condition in receiving mode. The stop condition is sent by the byte counter or requested by the interrupt.
+ */
+static void i2cDriver_startRead(void);
+
+/**
+ * Completes the current transaction with the specified status and starts the next one.
+ */
+static void i2cDriver_complete(I2CStatus_t status);
+
+/**
+ * Initializes the I2C module to be able to communicate with the sensorhub via I2C.
+ */
+void i2cDriver_init(void) {
+    P1SEL0 |= I2C_SDA_PIN + I2C_SCL_PIN;                            //Route the pins for the I2C module
+    UCB0CTLW0 |= UCSWRST;                                           //Enter SW reset mode (holds i2c module)
+    UCB0CTLW0 |= UCMST | UCMODE_3 | UCSYNC;                         //Master mode, i2c mode, synchronous mode
+    UCB0CTLW0 |= UCSSEL_2;                                          //Use SMCLK
+    UCB0BRW = 4;                                                    //fSCL = SMCLK/4 = 250kHz
+    gTransfer = NULL;
+    gQueueHead = NULL;
+    gQueueTail = NULL;
+    i2cDriver_enable();
+}
+
+/**
+ * Appends a transaction to the queue of the bus. If the bus is idle, the transaction is started right away. This is an atomic function.
+ */
+void i2cDriver_submit(I2CTransfer_t* transfer) {
+    unsigned short s;
+    transfer->status = I2C_PENDING;
+    transfer->next = NULL;
+    semaphor_init(&transfer->done);
+    ATOMIC_START(s);
+    if(gQueueTail == NULL) {
+        gQueueHead = transfer;
+    } else {
+        gQueueTail->next = transfer;
+    }
+    gQueueTail = transfer;
+    if(gTransfer == NULL) {
+        launchpad_requestSMCLK();                                   //The module is clocked by SMCLK until the queue is empty
+        i2cDriver_startNext();
+    }
+    ATOMIC_END(s);
+}
+
+/**
+ * Blocks the calling thread until the interrupt signals the end of the transaction. While waiting, the running transaction is watched:
+ * if it occupies the bus for longer than I2C_TRANSFER_TIMEOUT, the module is reset and the transaction is cancelled, which lets the queue continue.
+ */
+I2CStatus_t i2cDriver_wait(I2CTransfer_t* transfer) {
+    unsigned short s;
+    while(semaphor_timedP(&transfer->done, I2C_TRANSFER_TIMEOUT) != 0) {
+        ATOMIC_START(s);
+        if(gTransfer != NULL && (int32_t)(port_getSystemTicks() - gTransferStart) >= I2C_TRANSFER_TIMEOUT) {
+            UCB0CTLW0 |= UCSWRST;                                   //Reset the module, which also releases the bus
+            i2cDriver_enable();
+            i2cDriver_complete(I2C_ERROR_TIMEOUT);
+        }
+        ATOMIC_END(s);
+    }
+    return transfer->status;
+}
+
+/**
+ * Submits a transaction and blocks the calling thread until it is complete.
+ */
+I2CStatus_t i2cDriver_transfer(I2CTransfer_t* transfer) {
+    i2cDriver_submit(transfer);
+    return i2cDriver_wait(transfer);
+}
+
+/**
+ * Releases the module from the software reset and enables the required interrupts, which are cleared by the reset.
+ */
+static void i2cDriver_enable(void) {
+    UCB0CTLW0 &= ~UCSWRST;                                          //Clear SW reset (i2c module resumes operation)
+    UCB0IE |= UCTXIE0 | UCRXIE0 | UCNACKIE | UCSTPIE | UCALIE;      //Enable interrupts
+}
+
+/**
+ * Takes the first transaction from the queue and sends its start condition. Every following byte is handled by the interrupt.
+ * If the queue is empty, the request of SMCLK made by i2cDriver_submit is released.
+ * A transaction without any bytes is sent as a write, so it only checks if the device acknowledges its address.
+ * The byte counter and the automatic stop can only be configured while the module is in software reset, which is fine between two transactions.
+ * A read on its own lets the module send the stop after exactly rxLen bytes. Otherwise the automatic stop is disabled, because the counter
+ * also counts the written bytes and would end a write before its repeated start condition.
+ */
+static void i2cDriver_startNext(void) {
+    gTransfer = gQueueHead;
+    if(gTransfer == NULL) {
+        launchpad_releaseSMCLK();                                   //The bus is idle, so the CPU may enter LPM3
+        return;
+    }
+    gQueueHead = gTransfer->next;
+    if(gQueueHead == NULL) {
+        gQueueTail = NULL;
+    }
+    gTxIndex = 0;
+    gRxIndex = 0;
+    gResult = I2C_OK;
+    gTransferStart = port_getSystemTicks();
+    UCB0CTLW0 |= UCSWRST;
+    if(gTransfer->txLen == 0 && gTransfer->rxLen > 0 && gTransfer->rxLen <= 0xFF) {
+        UCB0CTLW1 = (UCB0CTLW1 & ~UCASTP_3) | UCASTP_2;             //Generate the stop condition once the byte counter reaches UCB0TBCNT
+        UCB0TBCNT = gTransfer->rxLen;
+    } else {
+        UCB0CTLW1 &= ~UCASTP_3;                                     //The interrupt requests the stop condition
+    }
+    i2cDriver_enable();
+    UCB0I2CSA = gTransfer->address;                                 //Set the slave device address
+    if(gTransfer->txLen > 0 || gTransfer->rxLen == 0) {
+        UCB0CTLW0 |= UCTR | UCTXSTT;                                //Send the start condition, the interrupt writes the bytes
+    } else {
+        i2cDriver_startRead();
+    }
+}
+
+/**
+ * Sends a start condition in receiving mode. Without the byte counter the stop condition is requested by the interrupt while the last byte
+ * is received. A single byte after a repeated start condition has no interrupt before it, so the stop has to be requested right after the
+ * address has been sent, as the user's guide requires. Only this case waits for the address. A read on its own never waits, the byte counter ends it.
+ */
+static void i2cDriver_startRead(void) {
+    UCB0CTLW0 &= ~UCTR;
+    UCB0CTLW0 |= UCTXSTT;
+    if(gTransfer->rxLen == 1 && !(UCB0CTLW1 & UCASTP_2)) {
+        while(UCB0CTLW0 & UCTXSTT);                                 //Wait for the address to be sent
+        UCB0CTLW0 |= UCTXSTP;
+    }
+}
+
+/**
+ * Completes the current transaction by storing its status and releasing its submitter. The next transaction is started immediately.
+ */
+static void i2cDriver_complete(I2CStatus_t status) {
+    I2CTransfer_t* transfer = gTransfer;
+    transfer->status = status;
+    semaphor_V(&transfer->done);
+    i2cDriver_startNext();
+}
+
+/**
+ * This interrupt runs the transactions byte by byte. A transaction ends with the stop condition, even if the device did not acknowledge,
+ * so the next transaction always finds a free bus.
+ */
+#if defined(__TI_COMPILER_VERSION__)
+#pragma vector = USCI_B0_VECTOR
+#endif
+__interrupt void USCI_B0_ISR(void)
+{
+  TRACE(TRACE_EVENT_ISR_ENTER, TRACE_THREAD_NONE, TRACE_ISR_USCI_B0);
+  switch(__even_in_range(UCB0IV, USCI_I2C_UCBIT9IFG)) {             //Tell the compiler that UCB0IV has to be an even value in range of USCI_I2C_UCBIT9IFG
+    case USCI_I2C_UCALIFG:                                          //Arbitration lost, there will not be a stop condition of this module
+      if(gTransfer != NULL) {
+          i2cDriver_complete(I2C_ERROR_ARBITRATION);
+          __bic_SR_register_on_exit(LPM3_bits);                     //Leave low power mode, so the released thread can run
+      }
+      break;
+
+    case USCI_I2C_UCNACKIFG:                                        //The device did not acknowledge, end the transaction
+      UCB0CTLW0 |= UCTXSTP;
+      gResult = I2C_ERROR_NACK;
+      break;
+
+    case USCI_I2C_UCSTPIFG:                                         //The stop condition has been sent, the transaction is complete
+      if(gTransfer != NULL) {
+          i2cDriver_complete(gResult);
+          __bic_SR_register_on_exit(LPM3_bits);                     //Leave low power mode, so the released thread can run
+      }
+      break;
+
+    case USCI_I2C_UCRXIFG0:                                         //A byte has been received
+      if(gTransfer != NULL && gRxIndex < gTransfer->rxLen) {
+          gTransfer->rxBuf[gRxIndex++] = UCB0RXBUF;
+          if(gRxIndex == gTransfer->rxLen - 1 && !(UCB0CTLW1 & UCASTP_2)) {  //Request the stop condition while the last byte is being received
+              UCB0CTLW0 |= UCTXSTP;
+          }
+      } else {
+          (void)UCB0RXBUF;
+      }
+      break;
+
+    case USCI_I2C_UCTXIFG0:                                         //The next byte can be written
+      if(gTransfer == NULL) {
+          UCB0CTLW0 |= UCTXSTP;
+      } else if(gTxIndex < gTransfer->txLen) {
+          UCB0TXBUF = gTransfer->txBuf[gTxIndex++];
+      } else if(gTransfer->rxLen > 0) {
+          i2cDriver_startRead();                                    //Continue with a repeated start condition
+      } else {
+          UCB0CTLW0 |= UCTXSTP;
+      }
+      break;
+    default: break;
+  }
+  TRACE(TRACE_EVENT_ISR_EXIT, TRACE_THREAD_NONE, TRACE_ISR_USCI_B0);
+}
@@ -0,0 +1,61 @@
+/*
+ * i2cDriver.h
+ *
+ *  This file defines the properties of the I2C module and the functions to run transactions on it. A transaction consists of an optional write
+ *  followed by an optional read with a repeated start condition. Transactions of any thread and for any device are queued and run back to back
+ *  by the interrupt, the submitting thread only waits for the completion of its own transaction.
+ *
+ */
+
+#ifndef DRIVERS_I2CDRIVER_H_
+#define DRIVERS_I2CDRIVER_H_
+
+#include <msp430.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "../semaphor.h"
+
+#define I2C_SDA_PIN                     (1 << 6)                //Defines the SDA (Signal Data) pin of the I2C module
+#define I2C_SCL_PIN                     (1 << 7)                //Defines the SCL (Signal Clock) pin of the I2C module
+#define I2C_TRANSFER_TIMEOUT            10                      //Defines the time in milliseconds (approx) a transaction may occupy the bus before it is cancelled
+
+typedef enum {                                                  //Defines the result of a transaction
+    I2C_OK = 0,
+    I2C_PENDING = 1,                                            //The transaction is queued or running
+    I2C_ERROR_NACK = -1,                                        //The device did not acknowledge its address or a byte
+    I2C_ERROR_ARBITRATION = -2,                                 //A different master took over the bus
+    I2C_ERROR_TIMEOUT = -3                                      //The transaction did not complete in time and the module has been reset
+} I2CStatus_t;
+
+typedef struct I2CTransfer {                                    //Defines a transaction with a device. The transaction must not be modified until it is complete
+    uint8_t address;                                            //Slave address of the device
+    const uint8_t* txBuf;                                       //Bytes to write first
+    size_t txLen;
+    uint8_t* rxBuf;                                             //Buffer for the bytes to read afterwards
+    size_t rxLen;
+    volatile I2CStatus_t status;                                //Result of the transaction, set by the driver
+    struct I2CTransfer* next;                                   //Links the transaction to the next one in the queue of the bus
+    Semaphor_t done;                                            //Released by the driver when the transaction is complete
+} I2CTransfer_t;
+
+/**
+ * Initializes the I2C module to be able to communicate with the sensorhub via I2C.
+ */
+void i2cDriver_init(void);
+
+/**
+ * Appends a transaction to the queue of the bus without waiting for it. A thread may submit several transactions, which are run back to back.
+ */
+void i2cDriver_submit(I2CTransfer_t* transfer);
+
+/**
+ * Blocks the calling thread until a submitted transaction is complete and returns its status.
+ */
+I2CStatus_t i2cDriver_wait(I2CTransfer_t* transfer);
+
+/**
+ * Submits a transaction and blocks the calling thread until it is complete. Returns the status of the transaction.
+ */
+I2CStatus_t i2cDriver_transfer(I2CTransfer_t* transfer);
+
+#endif /* DRIVERS_I2CDRIVER_H_ */
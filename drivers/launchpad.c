@@ -7,10 +7,27 @@
 
 #include "launchpad.h"
 #include "LEDDriver.h"
-#include "DisplayDriver.h"
+#include "displayDriver.h"
 #include "sensorDriver.h"
+#include "i2cDriver.h"
+#include "uartDriver.h"
+#include "telemetry.h"
+#include "temperatureConverter.h"
+#include "../trace.h"
 
-static uint32_t gSystemTicks = 0;                                                   //Current system ticks running
+static uint32_t gSystemTicks = 0;                                                   //System ticks at the time of the last timer interrupt
+static uint16_t gLastCompare = 0;                                                   //Timer count of the last timer interrupt
+static uint16_t gTimestampEpoch = 0;                                                //Upper 16 bit of the timestamp at the time of the last timer interrupt
+static uint16_t gTimerInterval = LAUNCHPAD_TIMER_MAX_INTERVAL;                      //System ticks between the last and the next timer interrupt
+static uint16_t gSMCLKRequests = 0;                                                 //Number of drivers that require SMCLK while the CPU is idle
+static uint32_t gPowerStart = 0;                                                    //Timestamp at which the power statistics started
+static uint32_t gLPM0Time = 0;                                                      //Timestamp counts spent in LPM0
+static uint32_t gLPM3Time = 0;                                                      //Timestamp counts spent in LPM3
+
+/**
+ * Initializes the clock system.
+ */
+static void launchpad_initClock(void);
 
 /**
  * Initializes the timer module.
@@ -18,9 +35,15 @@ static uint32_t gSystemTicks = 0;
 static void launchpad_initTimer(void);
 
 /**
- * The timer callback is to be implemented by the OS and is being called every time the relative system ticks since the last execution exceed the LAUNCHPAD_TIMER_PERIOD
+ * The timer callback is to be implemented by the OS and is being called every time the deadline requested with launchpad_setTimerDeadline is reached.
+ * The parameter contains the system ticks passed since the last execution.
+ */
+extern void timerCallback(uint16_t time);
+
+/**
+ * The switch callback is to be implemented by the OS and is being called by the switch interrupt requested with launchpad_requestSwitch.
  */
-extern void timerCallback();
+extern void switchCallback(void);
 
 /**
  * Initializes the launchpad and any dependant components via their respective drivers.
@@ -32,39 +55,232 @@ void launchpad_init(void) {
     ledDriver_init();                                                               //Initialize green and red LED
     displayDriver_init();                                                           //Initialize required display segments
     buttonDriver_init();                                                            //Initialize button 1
+    launchpad_initClock();                                                          //Initialize the clock of the timer
     launchpad_initTimer();                                                          //Initialize timer
-    sensorDriver_initI2C();                                                         //Initialize the I2C module
+    i2cDriver_init();                                                               //Initialize the I2C module
+    uartDriver_init();                                                              //Initialize the backchannel UART
 }
 
 /**
- * Initializes the timer module.
+ * Initializes the clock system. ACLK is sourced by the 32768Hz crystal of the launchpad, so the system timer keeps running in LPM3.
+ * MCLK and SMCLK keep running from the DCO. This waits until the crystal oscillates.
+ */
+static void launchpad_initClock(void) {
+    PJSEL0 |= BIT4 | BIT5;                                                          //Route the pins of the crystal
+    CSCTL0_H = CSKEY_H;                                                             //Unlock the clock system registers
+    CSCTL2 = (CSCTL2 & ~SELA_7) | SELA__LFXTCLK;                                    //ACLK from the crystal
+    CSCTL4 &= ~LFXTOFF;                                                             //Enable the crystal oscillator
+    do {
+        CSCTL5 &= ~LFXTOFFG;                                                        //Clear the fault flags until the crystal is stable
+        SFRIFG1 &= ~OFIFG;
+    } while(SFRIFG1 & OFIFG);
+    CSCTL0_H = 0;                                                                   //Lock the clock system registers
+    gPowerStart = 0;
+    gLPM0Time = 0;
+    gLPM3Time = 0;
+}
+
+/**
+ * Initializes the timer module. The timer runs in continuous mode and the compare register is moved forward to the next requested deadline,
+ * so the timer only interrupts the CPU when the OS has something to do.
  */
 static void launchpad_initTimer(void) {
-    TA0CTL = TASSEL_2 + MC_1 + ID_0;                                                //Configure TimerA0 to use SMCLK/8, upmode,
-    TA0CCR0 = 1000;                                                                 //Configure TimerA0 to count to this limit
+    gLastCompare = 0;
+    gTimestampEpoch = 0;
+    gTimerInterval = LAUNCHPAD_TIMER_MAX_INTERVAL;
+    TA0CCR0 = gTimerInterval << LAUNCHPAD_TICK_SHIFT;                               //Configure the first interrupt of TimerA0
     TA0CCTL0 = CCIE;                                                                //Configure interrupt for TimerA0
+    TA0CCTL2 = 0;                                                                   //The capture/compare register 2 only serves as switch interrupt
+    TA0CTL = TASSEL_1 + MC_2 + TACLR;                                               //Configure TimerA0 to use ACLK, continuous mode
+    TA1CTL = TASSEL_2 + MC_2 + TACLR;                                               //Configure TimerA1 as cycle counter, SMCLK runs at the frequency of MCLK
 }
 
 /**
- * Returns the current system ticks. A system tick depends on how the timer is initialized.
+ * Returns the current system ticks. A system tick depends on how the timer is initialized. The ticks since the last timer interrupt
+ * are derived from the timer count.
  */
 uint32_t launchpad_getSystemTicks(void) {
-    return gSystemTicks;
+    unsigned short s;
+    uint32_t ticks;
+    ATOMIC_START(s);
+    ticks = gSystemTicks + ((uint16_t)(launchpad_getTimerCount() - gLastCompare) >> LAUNCHPAD_TICK_SHIFT);
+    ATOMIC_END(s);
+    return ticks;
+}
+
+/**
+ * Returns a timestamp in counts of TimerA0. The counts of the last timer interrupt are derived from its system ticks and the counts since then are read from the timer.
+ */
+uint32_t launchpad_getTimestamp(void) {
+    unsigned short s;
+    uint32_t timestamp;
+    ATOMIC_START(s);
+    timestamp = (gSystemTicks << LAUNCHPAD_TICK_SHIFT) + (uint16_t)(launchpad_getTimerCount() - gLastCompare);
+    ATOMIC_END(s);
+    return timestamp;
+}
+
+/**
+ * Returns the count of TimerA0 in the lower 16 bit and the epoch of the last timer interrupt in the upper 16 bit. This only reads the timer and
+ * a global variable, the wrap of the timer since the last timer interrupt is left to the reader.
+ */
+uint32_t launchpad_getRawTimestamp(void) {
+    return ((uint32_t)gTimestampEpoch << 16) | launchpad_getTimerCount();
+}
+
+/**
+ * Programs the timer to execute the timerCallback at the specified absolute system tick. The compare register is set relative to the last
+ * timer interrupt, so no ticks get lost. If the timer interrupt is already pending it is left alone, because the OS requests a new deadline from the callback anyway.
+ * The counter may pass a close compare value before it is written, which would delay the interrupt by a whole wrap of the timer. Therefore the counter is
+ * read again afterwards and the interrupt flag is set, if the counts since the last timer interrupt already reach the new compare value.
+ */
+void launchpad_setTimerDeadline(uint32_t deadline) {
+    unsigned short s;
+    ATOMIC_START(s);
+    if(!(TA0CCTL0 & CCIFG)) {
+        int32_t interval = deadline - gSystemTicks;
+        uint16_t elapsed = (uint16_t)(launchpad_getTimerCount() - gLastCompare) >> LAUNCHPAD_TICK_SHIFT;
+        if(interval > LAUNCHPAD_TIMER_MAX_INTERVAL) {
+            interval = LAUNCHPAD_TIMER_MAX_INTERVAL;
+        }
+        if(interval <= (int32_t)elapsed) {                                          //The deadline has already passed, so interrupt on the next tick
+            interval = elapsed + 1;
+        }
+        gTimerInterval = interval;
+        TA0CCR0 = gLastCompare + (gTimerInterval << LAUNCHPAD_TICK_SHIFT);
+        if((uint16_t)(launchpad_getTimerCount() - gLastCompare) >= (uint16_t)(gTimerInterval << LAUNCHPAD_TICK_SHIFT)) {
+            TA0CCTL0 |= CCIFG;                                                      //The compare value has been passed while it was written
+        }
+    }
+    ATOMIC_END(s);
+}
+
+/**
+ * Returns the current count of TimerA0. ACLK is asynchronous to MCLK, so a single reading may be taken while the counter changes.
+ */
+uint16_t launchpad_getTimerCount(void) {
+    uint16_t count;
+    do {
+        count = TA0R;
+    } while(count != TA0R);
+    return count;
+}
+
+/**
+ * Returns the current count of TimerA1. The timer runs synchronously to the CPU, so a single reading is enough.
+ */
+uint16_t launchpad_getCycleCount(void) {
+    return TA1R;
+}
+
+/**
+ * Triggers the switch interrupt by setting the interrupt flag of the capture/compare register 2. With global interrupts disabled, which is the case
+ * in every interrupt and atomic section, the interrupt is pending until they are enabled again.
+ */
+void launchpad_requestSwitch(void) {
+    TA0CCTL2 = CCIE | CCIFG;
+}
+
+/**
+ * Enters low power mode with global interrupts enabled until the next interrupt occurs. Every interrupt that can resume a thread
+ * has to leave the low power mode on exit. Global interrupts are disabled again afterwards. LPM3 stops SMCLK, but keeps ACLK running,
+ * so the system timer, the button and the LCD keep working. The cycle counter is halted meanwhile, so it does not request SMCLK.
+ * The time until the CPU runs again is added to the statistics of the mode.
+ */
+void launchpad_idle(void) {
+    uint32_t start = launchpad_getTimestamp();
+    if(gSMCLKRequests > 0) {
+        __bis_SR_register(LPM0_bits | GIE);
+        __no_operation();
+        __disable_interrupt();
+        gLPM0Time += launchpad_getTimestamp() - start;
+    } else {
+        TA1CTL &= ~MC_3;                                                            //Halt the cycle counter
+        __bis_SR_register(LPM3_bits | GIE);
+        __no_operation();
+        __disable_interrupt();
+        TA1CTL |= MC_2;
+        gLPM3Time += launchpad_getTimestamp() - start;
+    }
+}
+
+/**
+ * Requests SMCLK to keep running while the CPU is idle. This is an atomic function.
+ */
+void launchpad_requestSMCLK(void) {
+    unsigned short s;
+    ATOMIC_START(s);
+    gSMCLKRequests++;
+    ATOMIC_END(s);
 }
 
 /**
- * Code that is executed every timer interrupt. This increments the system ticks and checks if LAUNCHPAD_TIMER_PERIOD has been exceeded.
- * If so, the timerCallback is executed.
+ * Releases a request of SMCLK. This is an atomic function.
+ */
+void launchpad_releaseSMCLK(void) {
+    unsigned short s;
+    ATOMIC_START(s);
+    if(gSMCLKRequests > 0) {
+        gSMCLKRequests--;
+    }
+    ATOMIC_END(s);
+}
+
+/**
+ * Copies the time spent in each power mode. The active time is the remaining time since the start of the statistics. This is an atomic function.
+ */
+void launchpad_getPowerStatistics(PowerStatistics_t* statistics) {
+    unsigned short s;
+    ATOMIC_START(s);
+    statistics->lpm0Time = gLPM0Time;
+    statistics->lpm3Time = gLPM3Time;
+    statistics->activeTime = launchpad_getTimestamp() - gPowerStart - gLPM0Time - gLPM3Time;
+    ATOMIC_END(s);
+}
+
+/**
+ * Code that is executed every timer interrupt. This advances the system ticks by the programmed interval, schedules the next interrupt
+ * after the maximum interval and executes the timerCallback, which may request an earlier deadline and a switch. The switch is executed
+ * by the switch interrupt right after this one. The CPU leaves low power mode on exit.
  */
 #pragma vector=TIMER0_A0_VECTOR
 __interrupt void TIMER0_A0_ISR_HOOK(void) {
-    static uint16_t count = 0;
+    uint16_t elapsed = gTimerInterval;
+    uint16_t compare;
+
+    TRACE(TRACE_EVENT_ISR_ENTER, TRACE_THREAD_NONE, TRACE_ISR_TIMER0_A0);
+
+    gSystemTicks += elapsed;
+    compare = gLastCompare + (elapsed << LAUNCHPAD_TICK_SHIFT);
+    if(compare < gLastCompare) {                                                    //The lower 16 bit of the timestamp wrapped, which is at most once per interval
+        gTimestampEpoch++;
+    }
+    gLastCompare = compare;
+    gTimerInterval = LAUNCHPAD_TIMER_MAX_INTERVAL;
+    TA0CCR0 = gLastCompare + (gTimerInterval << LAUNCHPAD_TICK_SHIFT);
+    __bic_SR_register_on_exit(LPM3_bits);                                           //Leave low power mode, so the idle loop runs a woken thread
+    timerCallback(elapsed);
+    TRACE(TRACE_EVENT_ISR_EXIT, TRACE_THREAD_NONE, TRACE_ISR_TIMER0_A0);
+}
 
-    gSystemTicks++;
-    if(count++ >= LAUNCHPAD_TIMER_INTERVAL) {
-        uint16_t c = count;
-        count = 0;
-        timerCallback(c);
+/**
+ * Code that is executed on the interrupts of the other capture/compare registers of TimerA0. The capture/compare register 1 is used by the buttonDriver,
+ * the capture/compare register 2 is the switch interrupt. Its interrupt is disabled again before the switchCallback, which may switch to a different thread.
+ */
+#pragma vector=TIMER0_A1_VECTOR
+__interrupt void TIMER0_A1_ISR_HOOK(void) {
+    switch(__even_in_range(TA0IV, TA0IV_TAIFG)) {
+    case TA0IV_TACCR1:
+        if(buttonDriver_timerInterrupt()) {
+            __bic_SR_register_on_exit(LPM3_bits);                                   //Leave low power mode, so the thread waiting for the event can run
+        }
+        break;
+    case TA0IV_TACCR2:
+        TA0CCTL2 = 0;
+        switchCallback();
+        break;
+    default:
+        break;
     }
 }
 
@@ -99,27 +315,51 @@ void launchpad_showTemperature(uint16_t sensorValue, TemperatureUnit_t unit) {
 }
 
 /**
- * Clears the LCD display by using the macro defined in the displayDriver.
+ * Display the temperature of a sensor value of the SHT21 in the specified unit on the LCD display.
+ * The sensor value is converted directly into the digits by the temperatureConverter, which does not require any division.
+ */
+void launchpad_showSensorValue(uint16_t sensorValue, TemperatureUnit_t unit) {
+    TemperatureDigits_t digits;
+    temperatureConverter_toDigits(sensorValue, unit, &digits);
+    displayDriver_showDigits(&digits, unit);
+}
+
+/**
+ * Clears the LCD display by delegating to the displayDriver.
  */
 void launchpad_clearDisplay(void) {
-    DISPLAY_CLEAR;
+    displayDriver_clear();
 }
 
 /**
  * Triggers a temperature measurement of the SHT21 via I2C by delegating to the sensorDriver.
  * A temperature measurement can take up to 100ms to return a result. For this reason the result needs to be
- * requested seperately after at least 100ms. Otherwise the result may be outdated.
+ * requested seperately after at least 100ms. Otherwise the result may be outdated. Returns possible error codes.
  */
-void launchpad_measureTemperature(void) {
-    sensorDriver_measureTemperature();
+int launchpad_measureTemperature(void) {
+    return sensorDriver_measureTemperature();
 }
 
 /**
  * Requests the result of a previously triggered temperature measurement by the sensorDriver.
- * Returns the sensor value, which needs to be converted to the respective unit.
+ * Writes the sensor value, which needs to be converted to the respective unit, and returns possible error codes.
+ */
+int launchpad_readTemperature(int16_t* sensorValue) {
+    return sensorDriver_readTemperature(sensorValue);
+}
+
+/**
+ * Copies the latest validated temperature sample of the sensorDriver.
  */
-int16_t launchpad_readTemperature(void) {
-    return sensorDriver_readTemperature();
+uint16_t launchpad_getTemperatureSample(TemperatureSample_t* sample) {
+    return sensorDriver_getLatestSample(sample);
+}
+
+/**
+ * Blocks the calling thread until the next event of the button 1 occurs by delegating to the buttonDriver.
+ */
+ButtonEvent_t launchpad_waitButtonEvent(void) {
+    return buttonDriver_waitEvent();
 }
 
 /**
@@ -129,3 +369,26 @@ unsigned char launchpad_getButtonState(void) {
     return BTN_STATE;
 }
 
+/**
+ * Sends a temperature sample on the telemetry stream by delegating to the telemetry driver.
+ */
+int launchpad_sendSample(const TemperatureSample_t* sample) {
+    return telemetry_sendSample(sample->timestamp, sample->value);
+}
+
+/**
+ * Sends the power statistics on the telemetry stream by delegating to the telemetry driver.
+ */
+int launchpad_sendPowerStatistics(void) {
+    PowerStatistics_t statistics;
+    launchpad_getPowerStatistics(&statistics);
+    return telemetry_sendPower(statistics.activeTime, statistics.lpm0Time, statistics.lpm3Time);
+}
+
+/**
+ * Sends a text on the telemetry stream by delegating to the telemetry driver.
+ */
+uint16_t launchpad_sendText(const char* text) {
+    return telemetry_sendText(text);
+}
+
@@ -16,15 +16,24 @@
 #include "sensorDriver.h"
 #include "buttonDriver.h"
 
-#define LAUNCHPAD_TIMER_INTERVAL    50                                                      //Defines the duration of a time slice for a thread. After this number of system ticks the timerCallback is executed, which is to be implemented by the OS
+#define LAUNCHPAD_TIMER_INTERVAL    50                                                      //Defines the default duration of a time slice for a thread in system ticks. The OS requests the timerCallback at the end of the slice while threads of the same priority are waiting to run
+#define LAUNCHPAD_TICK_SHIFT        5                                                       //Defines the length of a system tick as a power of two timer counts. 2^5 counts of ACLK (32768Hz) are approx. 1ms
+#define LAUNCHPAD_TIMER_MAX_INTERVAL 2047                                                   //Defines the maximum number of system ticks between two timer interrupts, limited by the 16 bit timer register
+#define LAUNCHPAD_TIMESTAMP_FREQUENCY 32768UL                                               //Defines the frequency of the timestamps in Hz, which is the frequency of TimerA0
+#define LAUNCHPAD_CYCLE_FREQUENCY   1000000UL                                               //Defines the frequency of the cycle counter TimerA1 in Hz, which counts SMCLK and therefore every cycle of MCLK
 
-#define THREADPOOL_SIZE             5                                                       //Defines the size of the threadpool, which limits how many concurrent threads can run
-#define STACKSIZE_PER_THREAD        256                                                     //Defines the stack size that each thread can be assigned
-#define STACK_UPPER_EDGE_ADDRESS    0x0023FF                                                //Defines the upper edge address of the stack to correctly divide the stack to each thread
+#define THREADPOOL_SIZE             6                                                       //Defines the size of the threadpool, which limits how many concurrent threads can run. The main thread takes one slot
+#define STACK_ARENA_SIZE            768                                                     //Defines the size of the memory from which the stacks of all threads except the main thread are carved. Keep the RAM of 2 KiB in mind
 
 #define ATOMIC_START(x)             x = _get_interrupt_state(); _disable_interrupts();      //Disables global interrupts and saves the interrupt state to a variable
 #define ATOMIC_END(x)               _set_interrupt_state(x);                                //Enables global interrupts and restores their interrupt state
 
+typedef struct {                                                                            //Defines the time spent in each power mode in counts of TimerA0. Counters may overflow
+    uint32_t activeTime;                                                                    //Time the CPU was running
+    uint32_t lpm0Time;                                                                      //Time spent in low power mode 0, because SMCLK was requested
+    uint32_t lpm3Time;                                                                      //Time spent in low power mode 3
+} PowerStatistics_t;
+
 /**
  * Initializes the launchpad and any dependant components via their respective drivers.
  */
@@ -35,6 +44,60 @@ void launchpad_init(void);
  */
 uint32_t launchpad_getSystemTicks(void);
 
+/**
+ * Returns a timestamp in counts of TimerA0 (LAUNCHPAD_TIMESTAMP_FREQUENCY), which has a much higher resolution than the system ticks. The timestamp overflows after approx. 36 hours.
+ */
+uint32_t launchpad_getTimestamp(void);
+
+/**
+ * Returns a raw timestamp, which is the count of TimerA0 in the lower 16 bit and the upper 16 bit of the timestamp at the last timer interrupt.
+ * It is 65536 counts too small, if the timer wrapped since the last timer interrupt. This has to be called with global interrupts disabled.
+ */
+uint32_t launchpad_getRawTimestamp(void);
+
+/**
+ * Programs the timer to execute the timerCallback at the specified absolute system tick. Deadlines in the past are executed on the next system tick
+ * and deadlines further away than LAUNCHPAD_TIMER_MAX_INTERVAL are capped. The timer does not interrupt the CPU in between.
+ */
+void launchpad_setTimerDeadline(uint32_t deadline);
+
+/**
+ * Triggers the switch interrupt, which executes the switchCallback as soon as global interrupts are enabled. The interrupt is triggered by software
+ * through the capture/compare register 2 of TimerA0, so it is only executed after the current interrupt like the PendSV of a Cortex-M.
+ */
+void launchpad_requestSwitch(void);
+
+/**
+ * Returns the current count of TimerA0. The timer runs asynchronously to the CPU, so it is read until two readings match.
+ */
+uint16_t launchpad_getTimerCount(void);
+
+/**
+ * Returns the current count of TimerA1, which counts the cycles of the CPU (LAUNCHPAD_CYCLE_FREQUENCY) and wraps after approx. 65ms. The counter stops in LPM3.
+ */
+uint16_t launchpad_getCycleCount(void);
+
+/**
+ * Enters the deepest low power mode, which keeps every requested clock running, with global interrupts enabled until the next interrupt occurs.
+ * Global interrupts are disabled again afterwards. This has to be called with global interrupts disabled.
+ */
+void launchpad_idle(void);
+
+/**
+ * Requests SMCLK to keep running while the CPU is idle, which limits the low power mode to LPM0. Every request has to be released again.
+ */
+void launchpad_requestSMCLK(void);
+
+/**
+ * Releases a request of launchpad_requestSMCLK.
+ */
+void launchpad_releaseSMCLK(void);
+
+/**
+ * Copies the time spent active and in each low power mode since the launchpad has been initialized.
+ */
+void launchpad_getPowerStatistics(PowerStatistics_t* statistics);
+
 /**
  * Toggles the green LED.
  */
@@ -61,20 +124,51 @@ void launchpad_clearDisplay(void);
  */
 void launchpad_showTemperature(uint16_t sensorValue, TemperatureUnit_t unit);
 
+/**
+ * Display the temperature of a sensor value of the SHT21 in the specified unit on the LCD display.
+ */
+void launchpad_showSensorValue(uint16_t sensorValue, TemperatureUnit_t unit);
+
 /**
  * Triggers a temperature measurement of the SHT21 via I2C. A temperature measurement can take up to 100ms to return a result. For this reason the result needs to be
- * requested seperately after at least 100ms. Otherwise the result may be outdated.
+ * requested seperately after at least 100ms. Otherwise the result may be outdated. Returns 0 on success and a negative I2CStatus_t otherwise.
+ */
+int launchpad_measureTemperature(void);
+
+/**
+ * Requests the result of a previously triggered temperature measurement. Writes the sensor value, which needs to be converted to the respective unit.
+ * Returns 0 on success and a negative I2CStatus_t otherwise.
  */
-void launchpad_measureTemperature(void);
+int launchpad_readTemperature(int16_t* sensorValue);
 
 /**
- * Requests the result of a previously triggered temperature measurement. Returns the sensor value, which needs to be converted to the respective unit.
+ * Copies the latest validated temperature sample with its timestamp. Returns the number of samples so far, which changes with every new sample.
  */
-int16_t launchpad_readTemperature(void);
+uint16_t launchpad_getTemperatureSample(TemperatureSample_t* sample);
+
+/**
+ * Blocks the calling thread until the next event of the button 1 occurs and returns it.
+ */
+ButtonEvent_t launchpad_waitButtonEvent(void);
 
 /**
  * Returns the current state of the button 1.
  */
 unsigned char launchpad_getButtonState(void);
 
+/**
+ * Sends a temperature sample on the telemetry stream of the backchannel UART without blocking. Returns 0 on success and -1 if the frame has been dropped.
+ */
+int launchpad_sendSample(const TemperatureSample_t* sample);
+
+/**
+ * Sends the time spent active and in each low power mode on the telemetry stream without blocking. Returns 0 on success and -1 if the frame has been dropped.
+ */
+int launchpad_sendPowerStatistics(void);
+
+/**
+ * Sends a text on the telemetry stream of the backchannel UART without blocking. Returns the number of characters sent, the rest has to be sent again later.
+ */
+uint16_t launchpad_sendText(const char* text);
+
 #endif /* LAUNCHPAD_H_ */
@@ -1,7 +1,7 @@
 /*
  * sensorDriver.h
  *
- *  This file defines the various properties required for the sensorhub and the I2C module and also some functions.
+ *  This file defines the various properties required for the sensorhub and also some functions.
  *
  */
 
@@ -12,15 +12,15 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#define I2C_SDA_PIN                     (1 << 6)                //Defines the SDA (Signal Data) pin of the I2C module
-#define I2C_SCL_PIN                     (1 << 7)                //Defines the SCL (Signal Clock) pin of the I2C module
 #define TEMPERATURE_SENSOR_ADDRESS      0x40                    //Defines the slave address of the SHT21 temperature sensor
 #define TEMPERATURE_SENSOR_COMMAND      0xF3                    //Defines the command to trigger a temperature measurement
+#define TEMPERATURE_SENSOR_CRC_POLYNOMIAL 0x31                  //Defines the CRC-8 polynomial x^8 + x^5 + x^4 + 1 of the SHT21 without the highest bit
+#define SENSOR_ERROR_CRC                -8                      //Defines the error code of a result whose checksum does not match
 
-/**
- * Initializes the I2C module to be able to communicate with the sensorhub via I2C.
- */
-void sensorDriver_initI2C(void);
+typedef struct {                                                //Defines a validated result of a temperature measurement
+    uint16_t value;                                             //Sensor value without the status bits, which needs to be converted to the respective unit
+    uint32_t timestamp;                                         //System ticks at which the result has been read
+} TemperatureSample_t;
 
 /**
  * Triggers a temperature measurement of the SHT21 via I2C. A temperature measurement can take up to 100ms to return a result. For this reason the result needs to be
@@ -29,8 +29,16 @@ void sensorDriver_initI2C(void);
 int sensorDriver_measureTemperature(void);
 
 /**
- * Requests the result of a previously triggered temperature measurement. Returns the sensor value, which needs to be converted to the respective unit.
+ * Requests the result of a previously triggered temperature measurement and writes the sensor value, which needs to be converted to the respective unit.
+ * Returns possible error codes, the SHT21 does not acknowledge while the measurement is still running. A result with a valid checksum
+ * also becomes the latest sample.
+ */
+int sensorDriver_readTemperature(int16_t* sensorValue);
+
+/**
+ * Copies the latest sample without disabling interrupts. Returns the number of samples read so far, which is 0 if there is no sample yet.
+ * The number changes with every new sample, so a reader can tell whether a sample is new.
  */
-int16_t sensorDriver_readTemperature(void);
+uint16_t sensorDriver_getLatestSample(TemperatureSample_t* sample);
 
 #endif /* DRIVERS_SENSORDRIVER_H_ */
@@ -0,0 +1,139 @@
+/*
+ * telemetry.c
+ *
+ *  This file implements the framing of the telemetry stream. The CRC of the type, the length and the payload is calculated before interrupts are disabled,
+ *  only the sequence number is added to it within the atomic section, which writes the whole frame into the ring buffer of the UART.
+ *
+ */
+
+#include "telemetry.h"
+#include "uartDriver.h"
+#include "launchpad.h"
+
+static uint8_t gSequence = 0;                                       //Sequence number of the next frame
+static uint32_t gFramesSent = 0;
+static uint32_t gFramesDropped = 0;
+
+/**
+ * Continues the CRC-8 over the specified bytes.
+ */
+static uint8_t telemetry_crc(uint8_t crc, const uint8_t* data, uint8_t length);
+
+/**
+ * Writes a value into a payload in little endian byte order and returns the position after it.
+ */
+static uint8_t* telemetry_putValue(uint8_t* position, uint32_t value, uint8_t size);
+
+/**
+ * Sends a frame. The frame is written with three writes in one atomic section, so the UART only starts it once it is complete.
+ */
+int telemetry_send(TelemetryType_t type, const uint8_t* payload, uint8_t length) {
+    unsigned short s;
+    uint8_t header[3] = { TELEMETRY_SYNC, type, length };
+    uint8_t trailer[2];
+    uint8_t crc;
+
+    if(length > TELEMETRY_MAX_PAYLOAD) {
+        return -1;
+    }
+    crc = telemetry_crc(0xFF, &header[1], 2);
+    crc = telemetry_crc(crc, payload, length);
+
+    ATOMIC_START(s);
+    if(uartDriver_getFree() < (size_t)length + TELEMETRY_OVERHEAD) {
+        gFramesDropped++;
+        ATOMIC_END(s);
+        return -1;
+    }
+    trailer[0] = gSequence++;
+    trailer[1] = telemetry_crc(crc, &trailer[0], 1);
+    uartDriver_write(header, sizeof(header));
+    uartDriver_write(payload, length);
+    uartDriver_write(trailer, sizeof(trailer));
+    gFramesSent++;
+    ATOMIC_END(s);
+    return 0;
+}
+
+/**
+ * Sends a temperature sample.
+ */
+int telemetry_sendSample(uint32_t timestamp, uint16_t value) {
+    uint8_t payload[6];
+    telemetry_putValue(telemetry_putValue(payload, timestamp, 4), value, 2);
+    return telemetry_send(TELEMETRY_TYPE_SAMPLE, payload, sizeof(payload));
+}
+
+/**
+ * Sends a record of the trace.
+ */
+int telemetry_sendTrace(const TraceRecord_t* record) {
+    uint8_t payload[8];
+    uint8_t* position = telemetry_putValue(telemetry_putValue(payload, record->count, 2), record->epoch, 2);
+    position = telemetry_putValue(position, record->event, 1);
+    telemetry_putValue(telemetry_putValue(position, record->thread, 1), record->argument, 2);
+    return telemetry_send(TELEMETRY_TYPE_TRACE, payload, sizeof(payload));
+}
+
+/**
+ * Sends the time spent active and in each low power mode.
+ */
+int telemetry_sendPower(uint32_t activeTime, uint32_t lpm0Time, uint32_t lpm3Time) {
+    uint8_t payload[12];
+    telemetry_putValue(telemetry_putValue(telemetry_putValue(payload, activeTime, 4), lpm0Time, 4), lpm3Time, 4);
+    return telemetry_send(TELEMETRY_TYPE_POWER, payload, sizeof(payload));
+}
+
+/**
+ * Sends the text frame by frame and stops at the first frame that does not fit.
+ */
+uint16_t telemetry_sendText(const char* text) {
+    uint16_t sent = 0;
+    while(text[sent] != '\0') {
+        uint8_t length = 0;
+        while(length < TELEMETRY_MAX_PAYLOAD && text[sent + length] != '\0') {
+            length++;
+        }
+        if(telemetry_send(TELEMETRY_TYPE_TEXT, (const uint8_t*)&text[sent], length) != 0) {
+            break;
+        }
+        sent += length;
+    }
+    return sent;
+}
+
+/**
+ * Copies the statistics of the telemetry stream. This is an atomic function.
+ */
+void telemetry_getStatistics(TelemetryStatistics_t* statistics) {
+    unsigned short s;
+    ATOMIC_START(s);
+    statistics->framesSent = gFramesSent;
+    statistics->framesDropped = gFramesDropped;
+    ATOMIC_END(s);
+}
+
+/**
+ * Continues the CRC-8 bit by bit, which needs no table.
+ */
+static uint8_t telemetry_crc(uint8_t crc, const uint8_t* data, uint8_t length) {
+    while(length-- > 0) {
+        uint8_t bit;
+        crc ^= *data++;
+        for(bit = 0; bit < 8; bit++) {
+            crc = crc & 0x80 ? (crc << 1) ^ TELEMETRY_CRC_POLYNOMIAL : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/**
+ * Writes the lowest size bytes of a value, starting with the least significant one.
+ */
+static uint8_t* telemetry_putValue(uint8_t* position, uint32_t value, uint8_t size) {
+    while(size-- > 0) {
+        *position++ = (uint8_t)value;
+        value >>= 8;
+    }
+    return position;
+}
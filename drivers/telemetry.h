@@ -0,0 +1,68 @@
+/*
+ * telemetry.h
+ *
+ *  This file defines the binary frames of the telemetry stream on the backchannel UART and the functions to send them. A frame consists of
+ *
+ *      TELEMETRY_SYNC | type | length | payload (length bytes) | sequence | CRC-8
+ *
+ *  The sequence number is incremented with every frame, so a receiver detects dropped frames. The CRC covers every byte after the sync byte,
+ *  so a receiver resynchronizes on the next sync byte after a damaged frame. Every value of a payload is little endian.
+ *
+ */
+
+#ifndef DRIVERS_TELEMETRY_H_
+#define DRIVERS_TELEMETRY_H_
+
+#include <stdint.h>
+#include "../trace.h"
+
+#define TELEMETRY_SYNC                  0xA5                    //Defines the first byte of every frame
+#define TELEMETRY_MAX_PAYLOAD           32                      //Defines the maximum length of a payload in bytes
+#define TELEMETRY_OVERHEAD              5                       //Defines the number of bytes of a frame besides its payload
+#define TELEMETRY_CRC_POLYNOMIAL        0x07                    //Defines the CRC-8 polynomial x^8 + x^2 + x + 1 without the highest bit. The CRC starts with 0xFF
+
+typedef enum {                                                  //Defines the types of frames
+    TELEMETRY_TYPE_SAMPLE = 1,                                  //uint32_t timestamp in system ticks, uint16_t sensor value of the SHT21
+    TELEMETRY_TYPE_TRACE = 2,                                   //uint16_t count, uint16_t epoch, uint8_t event, uint8_t thread, uint16_t argument of a TraceRecord_t
+    TELEMETRY_TYPE_POWER = 3,                                   //uint32_t active time, uint32_t LPM0 time, uint32_t LPM3 time in counts of TimerA0
+    TELEMETRY_TYPE_TEXT = 4                                     //Characters of a text line, which continues in the next text frame until a newline
+} TelemetryType_t;
+
+typedef struct {                                                //Defines the statistics of the telemetry stream
+    uint32_t framesSent;                                        //Frames written into the ring buffer of the UART
+    uint32_t framesDropped;                                     //Frames rejected, because the ring buffer was full
+} TelemetryStatistics_t;
+
+/**
+ * Sends a frame with the specified payload without blocking. Returns 0 on success and -1 if the payload is too long or the frame does not fit into the
+ * ring buffer of the UART, in which case the frame is dropped. Frames of different threads and interrupts are never interleaved.
+ */
+int telemetry_send(TelemetryType_t type, const uint8_t* payload, uint8_t length);
+
+/**
+ * Sends a temperature sample.
+ */
+int telemetry_sendSample(uint32_t timestamp, uint16_t value);
+
+/**
+ * Sends a record of the trace.
+ */
+int telemetry_sendTrace(const TraceRecord_t* record);
+
+/**
+ * Sends the time spent active and in each low power mode.
+ */
+int telemetry_sendPower(uint32_t activeTime, uint32_t lpm0Time, uint32_t lpm3Time);
+
+/**
+ * Sends a text in frames of up to TELEMETRY_MAX_PAYLOAD characters. Returns the number of characters sent, which is less than the length of the text
+ * if the ring buffer of the UART is full, so the caller can send the rest later.
+ */
+uint16_t telemetry_sendText(const char* text);
+
+/**
+ * Copies the statistics of the telemetry stream.
+ */
+void telemetry_getStatistics(TelemetryStatistics_t* statistics);
+
+#endif /* DRIVERS_TELEMETRY_H_ */
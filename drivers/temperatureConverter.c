@@ -0,0 +1,64 @@
+/*
+ * temperatureConverter.c
+ *
+ *  This file implements the conversion of sensor values into digits. A division by 10 is replaced by a multiplication with the reciprocal
+ *  52429 / 2^19, which gives the exact quotient for every value below 81920. The results are the same as the former conversion with
+ *  divisions, which truncated towards zero.
+ *
+ */
+
+#include "temperatureConverter.h"
+
+/**
+ * Divides an unsigned value by 10 with the reciprocal multiplier.
+ */
+static inline uint16_t temperatureConverter_divideBy10(uint16_t value);
+
+/**
+ * Divides a signed value by 10 and truncates towards zero.
+ */
+static inline int16_t temperatureConverter_divideSignedBy10(int16_t value);
+
+/**
+ * Converts a sensor value into C with two decimal places, then truncates it to one decimal place and converts it to F if required.
+ * The sensor value times TEMPERATURE_SCALE / 2^16 is at most 17572, so every step fits into 16 bits.
+ */
+void temperatureConverter_toDigits(uint16_t sensorValue, TemperatureUnit_t unit, TemperatureDigits_t* digits) {
+    int16_t temperature = (int16_t)(((uint32_t)sensorValue * TEMPERATURE_SCALE) >> 16) - TEMPERATURE_OFFSET;
+    temperature = temperatureConverter_divideSignedBy10(temperature);
+    if(unit == FAHRENHEIT) {
+        temperature = temperatureConverter_divideSignedBy10(temperature * 18) + FAHRENHEIT_OFFSET;
+    }
+    temperatureConverter_fromTemperature(temperature, digits);
+}
+
+/**
+ * Converts the magnitude of a temperature into 4 BCD digits, the lowest nibble holds the decimal place.
+ */
+void temperatureConverter_fromTemperature(Temperature_t temperature, TemperatureDigits_t* digits) {
+    uint16_t magnitude = temperature < 0 ? -(uint16_t)temperature : (uint16_t)temperature;
+    uint16_t bcd = 0;
+    uint8_t i;
+
+    for(i = 0; i < 16; i += 4) {
+        uint16_t quotient = temperatureConverter_divideBy10(magnitude);
+        bcd |= (magnitude - quotient * 10) << i;
+        magnitude = quotient;
+    }
+    digits->bcd = bcd;
+    digits->negative = temperature < 0;
+}
+
+/**
+ * Divides an unsigned value by 10 with the reciprocal multiplier, which is exact for every 16 bit value.
+ */
+static inline uint16_t temperatureConverter_divideBy10(uint16_t value) {
+    return (uint16_t)(((uint32_t)value * 52429UL) >> 19);
+}
+
+/**
+ * Divides a signed value by 10 and truncates towards zero like the division operator.
+ */
+static inline int16_t temperatureConverter_divideSignedBy10(int16_t value) {
+    return value < 0 ? -(int16_t)temperatureConverter_divideBy10(-value) : (int16_t)temperatureConverter_divideBy10(value);
+}
@@ -0,0 +1,29 @@
+/*
+ * temperatureConverter.h
+ *
+ *  This file defines the functions to convert sensor values of the SHT21 into the digits shown on the display. The conversion only uses
+ *  multiplications and shifts, because the MSP430 has a hardware multiplier, but no divider.
+ *
+ */
+
+#ifndef DRIVERS_TEMPERATURECONVERTER_H_
+#define DRIVERS_TEMPERATURECONVERTER_H_
+
+#include <inttypes.h>
+#include "displayDriver.h"
+
+#define TEMPERATURE_SCALE           17572                       //Defines the span of the SHT21 temperature range in 1/100 C (175.72 C)
+#define TEMPERATURE_OFFSET          4685                        //Defines the lowest temperature of the SHT21 in -1/100 C (-46.85 C)
+#define FAHRENHEIT_OFFSET           320                         //Defines 32 F with one decimal place multiplied by 10
+
+/**
+ * Converts a sensor value of the SHT21 into the digits of the temperature in the specified unit with one decimal place.
+ */
+void temperatureConverter_toDigits(uint16_t sensorValue, TemperatureUnit_t unit, TemperatureDigits_t* digits);
+
+/**
+ * Converts a temperature with one decimal place multiplied by 10 into its digits. Only the lowest 4 digits are kept.
+ */
+void temperatureConverter_fromTemperature(Temperature_t temperature, TemperatureDigits_t* digits);
+
+#endif /* DRIVERS_TEMPERATURECONVERTER_H_ */
@@ -0,0 +1,154 @@
+/*
+ * uartDriver.c
+ *
+ *  This file implements the transmitter of the backchannel UART eUSCI_A1 with the DMA channel 0. The DMA always sends the contiguous bytes from the
+ *  oldest byte up to the latest one or the end of the ring buffer, whatever comes first, and its interrupt starts the next part. SMCLK is requested
+ *  from the first byte until the module has shifted out the last one.
+ *
+ */
+
+#include "uartDriver.h"
+#include "launchpad.h"
+
+#if defined(__TI_COMPILER_VERSION__)
+#pragma PERSISTENT(gBuffer)                                         //The buffer is kept in FRAM like the trace, which saves a quarter of the RAM
+#endif
+static uint8_t gBuffer[UART_BUFFER_SIZE] = { 0 };                   //Ring buffer of the bytes to send
+static volatile uint16_t gHead = 0;                                 //Index of the next byte to write
+static volatile uint16_t gTail = 0;                                 //Index of the oldest byte, which is the first byte of the running transfer
+static volatile uint16_t gCount = 0;                                //Number of bytes in the ring buffer including the running transfer
+static volatile uint16_t gTransfer = 0;                             //Number of bytes of the running transfer, 0 if the DMA is idle
+static volatile uint8_t gActive = 0;                                //Set while SMCLK is requested for the transmitter
+static uint32_t gBytesSent = 0;
+static uint16_t gPeakUsage = 0;
+
+/**
+ * Starts the DMA for the contiguous bytes at the tail of the ring buffer.
+ */
+static void uartDriver_startTransfer(void);
+
+/**
+ * Initializes eUSCI_A1 as UART and the DMA channel 0, which is triggered whenever the transmit buffer of the module is empty.
+ */
+void uartDriver_init(void) {
+    P3SEL0 |= UART_TX_PIN | UART_RX_PIN;                            //Route the pins for the UART
+    P3SEL1 &= ~(UART_TX_PIN | UART_RX_PIN);
+    UCA1CTLW0 = UCSWRST | UCSSEL__SMCLK;                            //Hold the module in SW reset and use SMCLK
+    UCA1BRW = 8;                                                    //115200 baud from 1MHz without oversampling: UCBRx = 8, UCBRSx = 0xD6
+    UCA1MCTLW = 0xD600;
+    UCA1CTLW0 &= ~UCSWRST;                                          //Clear SW reset (module resumes operation)
+
+    DMACTL0 = (DMACTL0 & ~DMA0TSEL_31) | DMA0TSEL__UCA1TXIFG;       //Trigger channel 0 with the transmit interrupt flag of eUSCI_A1
+    DMACTL4 = DMARMWDIS;                                            //Do not interrupt read-modify-write instructions of the CPU
+    __data16_write_addr((unsigned short)&DMA0DA, (unsigned long)&UCA1TXBUF);
+    gHead = 0;
+    gTail = 0;
+    gCount = 0;
+    gTransfer = 0;
+    gActive = 0;
+}
+
+/**
+ * Returns the number of free bytes in the ring buffer.
+ */
+size_t uartDriver_getFree(void) {
+    return UART_BUFFER_SIZE - gCount;
+}
+
+/**
+ * Copies the bytes into the ring buffer. An idle transmitter requests SMCLK and starts the DMA, a transmitter, which is only waiting for the last byte
+ * to be shifted out, keeps SMCLK and continues with the new bytes. Otherwise the interrupt of the running transfer starts the new bytes. This is an atomic function.
+ */
+int uartDriver_write(const uint8_t* data, size_t length) {
+    unsigned short s;
+    ATOMIC_START(s);
+    if(length > UART_BUFFER_SIZE - gCount) {
+        ATOMIC_END(s);
+        return -1;
+    }
+    while(length-- > 0) {
+        gBuffer[gHead] = *data++;
+        gHead = (gHead + 1) & (UART_BUFFER_SIZE - 1);
+        gCount++;
+    }
+    if(gCount > gPeakUsage) {
+        gPeakUsage = gCount;
+    }
+    if(gTransfer == 0 && gCount > 0) {
+        if(!gActive) {
+            gActive = 1;
+            launchpad_requestSMCLK();                               //The module is clocked by SMCLK until the last byte has been sent
+        }
+        UCA1IE &= ~UCTXCPTIE;
+        uartDriver_startTransfer();
+    }
+    ATOMIC_END(s);
+    return 0;
+}
+
+/**
+ * Copies the statistics of the transmitter. This is an atomic function.
+ */
+void uartDriver_getStatistics(UARTStatistics_t* statistics) {
+    unsigned short s;
+    ATOMIC_START(s);
+    statistics->bytesSent = gBytesSent;
+    statistics->peakUsage = gPeakUsage;
+    ATOMIC_END(s);
+}
+
+/**
+ * Starts a single block transfer of the DMA from the tail up to the head or the end of the ring buffer into the transmit buffer of the module.
+ * The trigger is edge sensitive and the transmit interrupt flag is already set while the module is idle, so the flag is set again to trigger the first byte.
+ */
+static void uartDriver_startTransfer(void) {
+    gTransfer = gTail + gCount <= UART_BUFFER_SIZE ? gCount : UART_BUFFER_SIZE - gTail;
+    __data16_write_addr((unsigned short)&DMA0SA, (unsigned long)&gBuffer[gTail]);
+    DMA0SZ = gTransfer;
+    DMA0CTL = DMADT_0 | DMASRCINCR_3 | DMADSTINCR_0 | DMASBDB | DMAIE | DMAEN;  //Single transfer, increment the source, bytes to bytes
+    UCA1IFG &= ~UCTXIFG;
+    UCA1IFG |= UCTXIFG;
+}
+
+/**
+ * This interrupt is executed when the DMA has written the last byte of a transfer to the module. It frees the bytes of the transfer and starts the next one.
+ * If the ring buffer is empty, the module signals when it has shifted out the last byte.
+ */
+#pragma vector = DMA_VECTOR
+__interrupt void DMA_ISR(void)
+{
+  switch(__even_in_range(DMAIV, DMAIV_DMA2IFG)) {
+    case DMAIV_DMA0IFG:
+      gTail = (gTail + gTransfer) & (UART_BUFFER_SIZE - 1);
+      gCount -= gTransfer;
+      gBytesSent += gTransfer;
+      gTransfer = 0;
+      if(gCount > 0) {
+          uartDriver_startTransfer();
+      } else {
+          UCA1IFG &= ~UCTXCPTIFG;
+          UCA1IE |= UCTXCPTIE;                                      //Wait for the last byte before SMCLK is released
+      }
+      break;
+    default: break;
+  }
+}
+
+/**
+ * This interrupt is executed when the module has shifted out the last byte. SMCLK is released, unless new bytes have been written meanwhile.
+ */
+#pragma vector = USCI_A1_VECTOR
+__interrupt void USCI_A1_ISR(void)
+{
+  switch(__even_in_range(UCA1IV, USCI_UART_UCTXCPTIFG)) {
+    case USCI_UART_UCTXCPTIFG:
+      UCA1IE &= ~UCTXCPTIE;
+      if(gActive && gTransfer == 0) {
+          gActive = 0;
+          launchpad_releaseSMCLK();
+          __bic_SR_register_on_exit(LPM3_bits);                     //Leave low power mode, so the idle loop may enter LPM3
+      }
+      break;
+    default: break;
+  }
+}
@@ -0,0 +1,46 @@
+/*
+ * uartDriver.h
+ *
+ *  This file defines the properties of the backchannel UART of the launchpad and the functions to transmit on it. Bytes are copied into a ring buffer
+ *  and sent by the DMA, so the CPU is not involved per byte. Writing never blocks, a write which does not fit into the ring buffer is rejected as a whole.
+ *
+ */
+
+#ifndef DRIVERS_UARTDRIVER_H_
+#define DRIVERS_UARTDRIVER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define UART_TX_PIN                     (1 << 4)                //Defines the TXD pin of eUSCI_A1 on port 3, which is connected to the backchannel of the debugger
+#define UART_RX_PIN                     (1 << 5)                //Defines the RXD pin of eUSCI_A1 on port 3
+#define UART_BUFFER_SIZE                256                     //Defines the size of the ring buffer in bytes. Must be a power of two
+#define UART_BAUDRATE                   115200                  //Defines the baudrate, which is derived from SMCLK (1MHz)
+
+typedef struct {                                                //Defines the statistics of the transmitter
+    uint32_t bytesSent;                                         //Bytes the DMA has written to the module
+    uint16_t peakUsage;                                         //Highest number of bytes in the ring buffer so far
+} UARTStatistics_t;
+
+/**
+ * Initializes eUSCI_A1 as UART with UART_BAUDRATE, 8 data bits, no parity and one stop bit and the DMA channel 0 to feed it.
+ */
+void uartDriver_init(void);
+
+/**
+ * Returns the number of bytes, which currently fit into the ring buffer.
+ */
+size_t uartDriver_getFree(void);
+
+/**
+ * Copies the bytes into the ring buffer and starts the transmission, if the transmitter is idle. Returns 0 on success and -1 if the bytes do not fit,
+ * in which case nothing is written. This is an atomic function, which may be called from threads and interrupts.
+ */
+int uartDriver_write(const uint8_t* data, size_t length);
+
+/**
+ * Copies the statistics of the transmitter.
+ */
+void uartDriver_getStatistics(UARTStatistics_t* statistics);
+
+#endif /* DRIVERS_UARTDRIVER_H_ */
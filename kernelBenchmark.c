@@ -0,0 +1,381 @@
+/**
+ * kernelBenchmark.c
+ *
+ * This file contains the implementation of the functionality declared in kernelBenchmark.h.
+ *
+ */
+
+#if defined(__linux__)
+#undef _FORTIFY_SOURCE                                                  //The checked longjmp of the C library does not allow to jump to a different stack
+#endif
+#include <setjmp.h>
+#include <string.h>
+#include "kernelBenchmark.h"
+#include "scheduler.h"
+#include "semaphor.h"
+
+#define KERNELBENCHMARK_LARGEST     (KERNELBENCHMARK_ITERATIONS / 100 + 1)  //Number of largest samples that are kept to determine the 99th percentile
+#define KERNELBENCHMARK_RAW_MEMORY_SIZE (2 * KERNELBENCHMARK_STACK_SIZE)     //Memory of the contexts of the raw switch benchmarks, which is part of the stack of the benchmark thread
+
+typedef struct {                                                        //Defines the samples of a benchmark so far. Only the largest ones are kept
+    uint32_t min;
+    uint32_t sum;
+    uint16_t count;
+    uint32_t largest[KERNELBENCHMARK_LARGEST];                          //Largest samples in descending order
+} KernelBenchmarkSamples_t;
+
+static const char* const gNames[KERNELBENCHMARK_COUNT] = {              //Names of the benchmarks
+    "contextSwitch",
+    "semaphorPingPong",
+    "sleep",
+    "wakeupLatency",
+    "portSwitch",
+    "setjmpSwitch"
+};
+
+static KernelBenchmarkSamples_t gSamples[2];                            //Samples of the running benchmark. Only the sleep benchmark uses the second one
+static Semaphor_t gDone;                                                //Released by every benchmark thread when it is finished
+static Semaphor_t gPing;                                                //Semaphors of the ping pong benchmark
+static Semaphor_t gPong;
+static volatile PortCycles_t gSwitchStart;                              //Cycles before the last switch of the context switch benchmark
+static volatile uint16_t gRemaining;                                    //Number of samples the running benchmark still has to take
+static PortContext_t gThreadContext;                                    //Contexts of the raw switch benchmarks, which are switched without the scheduler
+static PortContext_t gRawContext;
+static jmp_buf gThreadJump;
+static jmp_buf gRawJump;
+static volatile unsigned char gRawSetjmp;                               //Tells the second context to switch with setjmp/longjmp instead of port_switchContext
+
+/**
+ * Runs a benchmark with the specified threads, waits until all of them are finished and evaluates the samples, which are taken with the specified frequency.
+ */
+static int kernelBenchmark_runThreads(KernelBenchmarkResult_t* results, ThreadFunction_t first, ThreadFunction_t second, size_t stackSize, uint32_t frequency);
+
+/**
+ * Adds a sample to a set of samples.
+ */
+static void kernelBenchmark_addSample(KernelBenchmarkSamples_t* samples, uint32_t sample);
+
+/**
+ * Writes the result of a set of samples.
+ */
+static void kernelBenchmark_evaluate(const KernelBenchmarkSamples_t* samples, KernelBenchmarkResult_t* result, uint32_t frequency);
+
+/**
+ * Appends a string to a line and returns the position after it.
+ */
+static char* kernelBenchmark_putString(char* position, const char* string);
+
+/**
+ * Appends an unsigned value in decimal to a line and returns the position after it.
+ */
+static char* kernelBenchmark_putValue(char* position, uint32_t value);
+
+/**
+ * Thread of the context switch benchmark. Both threads run this function.
+ */
+static void kernelBenchmark_switchThread(void);
+
+/**
+ * Thread of the ping pong benchmark, which measures the round trip.
+ */
+static void kernelBenchmark_pingThread(void);
+
+/**
+ * Thread of the ping pong benchmark, which answers.
+ */
+static void kernelBenchmark_pongThread(void);
+
+/**
+ * Thread of the sleep benchmark, which also measures the wake-up latency.
+ */
+static void kernelBenchmark_sleepThread(void);
+
+/**
+ * Thread of the raw switch benchmarks, which switches to a second context on its own stack.
+ */
+static void kernelBenchmark_rawSwitchThread(void);
+
+/**
+ * Entry of the second context of the raw switch benchmarks, which switches back right away. This function never returns.
+ */
+static void kernelBenchmark_rawEntry(void);
+
+/**
+ * Runs every benchmark. The sleep benchmark writes the results of the sleep and the wake-up latency, the raw switch benchmark the results
+ * of port_switchContext and setjmp/longjmp.
+ */
+int kernelBenchmark_run(KernelBenchmarkResult_t results[KERNELBENCHMARK_COUNT]) {
+    memset(results, 0, KERNELBENCHMARK_COUNT * sizeof(KernelBenchmarkResult_t));
+    if(kernelBenchmark_runThreads(&results[KERNELBENCHMARK_CONTEXT_SWITCH], &kernelBenchmark_switchThread, &kernelBenchmark_switchThread,
+                                  KERNELBENCHMARK_STACK_SIZE, PORT_CYCLE_FREQUENCY) != 0) {
+        return -1;
+    }
+    if(kernelBenchmark_runThreads(&results[KERNELBENCHMARK_SEMAPHOR_PINGPONG], &kernelBenchmark_pingThread, &kernelBenchmark_pongThread,
+                                  KERNELBENCHMARK_STACK_SIZE, PORT_CYCLE_FREQUENCY) != 0) {
+        return -1;
+    }
+    if(kernelBenchmark_runThreads(&results[KERNELBENCHMARK_SLEEP], &kernelBenchmark_sleepThread, NULL,
+                                  KERNELBENCHMARK_STACK_SIZE, PORT_TIMESTAMP_FREQUENCY) != 0) {
+        return -1;
+    }
+    return kernelBenchmark_runThreads(&results[KERNELBENCHMARK_PORT_SWITCH], &kernelBenchmark_rawSwitchThread, NULL,
+                                      KERNELBENCHMARK_STACK_SIZE + KERNELBENCHMARK_RAW_MEMORY_SIZE, PORT_CYCLE_FREQUENCY);
+}
+
+/**
+ * Returns the name of a benchmark.
+ */
+const char* kernelBenchmark_getName(KernelBenchmark_t benchmark) {
+    return benchmark < KERNELBENCHMARK_COUNT ? gNames[benchmark] : "";
+}
+
+/**
+ * Formats the result of a benchmark without the printf family of the C library, which needs more stack than a thread of the launchpad has.
+ */
+uint16_t kernelBenchmark_format(char* line, KernelBenchmark_t benchmark, const KernelBenchmarkResult_t* result) {
+    char* position = kernelBenchmark_putString(line, "{\"name\":\"");
+    position = kernelBenchmark_putString(position, kernelBenchmark_getName(benchmark));
+    position = kernelBenchmark_putValue(kernelBenchmark_putString(position, "\",\"min\":"), result->min);
+    position = kernelBenchmark_putValue(kernelBenchmark_putString(position, ",\"mean\":"), result->mean);
+    position = kernelBenchmark_putValue(kernelBenchmark_putString(position, ",\"p99\":"), result->p99);
+    position = kernelBenchmark_putValue(kernelBenchmark_putString(position, ",\"count\":"), result->count);
+    position = kernelBenchmark_putValue(kernelBenchmark_putString(position, ",\"frequency\":"), result->frequency);
+    position = kernelBenchmark_putString(position, "}\n");
+    return (uint16_t)(position - line);
+}
+
+/**
+ * Resets the samples and starts the threads within one atomic section, so neither thread runs before the other one exists. If the second thread
+ * cannot be started, the first one finds no samples left and finishes right away. Afterwards this waits until every started thread has released gDone
+ * and writes the results of both sets of samples to the result of the benchmark and the one following it.
+ */
+static int kernelBenchmark_runThreads(KernelBenchmarkResult_t* results, ThreadFunction_t first, ThreadFunction_t second, size_t stackSize, uint32_t frequency) {
+    unsigned short s;
+    unsigned int threads = 0;
+    int err = 0;
+
+    memset(gSamples, 0, sizeof(gSamples));
+    gSamples[0].min = UINT32_MAX;
+    gSamples[1].min = UINT32_MAX;
+    gRemaining = KERNELBENCHMARK_ITERATIONS;
+    semaphor_init(&gDone);
+    semaphor_init(&gPing);
+    semaphor_init(&gPong);
+
+    ATOMIC_START(s);
+    if(scheduler_startThread(first, KERNELBENCHMARK_PRIORITY, stackSize) != THREAD_ID_INVALID) {
+        threads++;
+        if(second != NULL && scheduler_startThread(second, KERNELBENCHMARK_PRIORITY, stackSize) != THREAD_ID_INVALID) {
+            threads++;
+        } else if(second != NULL) {
+            gRemaining = 0;
+            err = -1;
+        }
+    } else {
+        err = -1;
+    }
+    ATOMIC_END(s);
+
+    while(threads-- > 0) {
+        semaphor_P(&gDone);
+    }
+    kernelBenchmark_evaluate(&gSamples[0], &results[0], frequency);
+    if(second == NULL) {
+        kernelBenchmark_evaluate(&gSamples[1], &results[1], frequency);
+    }
+    return err;
+}
+
+/**
+ * Adds a sample. The sample is inserted into the sorted largest samples, if it is larger than the smallest of them.
+ */
+static void kernelBenchmark_addSample(KernelBenchmarkSamples_t* samples, uint32_t sample) {
+    unsigned int i = KERNELBENCHMARK_LARGEST;
+
+    if(sample < samples->min) {
+        samples->min = sample;
+    }
+    samples->sum += sample;
+    samples->count++;
+    while(i > 0 && samples->largest[i - 1] < sample) {
+        if(i < KERNELBENCHMARK_LARGEST) {
+            samples->largest[i] = samples->largest[i - 1];
+        }
+        i--;
+    }
+    if(i < KERNELBENCHMARK_LARGEST) {
+        samples->largest[i] = sample;
+    }
+}
+
+/**
+ * Writes the result of a set of samples. The 99th percentile is the sample, which is exceeded by 1% of all samples, so it is one of the kept largest samples.
+ */
+static void kernelBenchmark_evaluate(const KernelBenchmarkSamples_t* samples, KernelBenchmarkResult_t* result, uint32_t frequency) {
+    unsigned int index = samples->count / 100;
+    if(samples->count == 0) {
+        return;
+    }
+    result->min = samples->min;
+    result->mean = samples->sum / samples->count;
+    result->p99 = samples->largest[index < KERNELBENCHMARK_LARGEST ? index : KERNELBENCHMARK_LARGEST - 1];
+    result->frequency = frequency;
+    result->count = samples->count;
+}
+
+/**
+ * Copies the characters of a string without its terminating zero.
+ */
+static char* kernelBenchmark_putString(char* position, const char* string) {
+    while(*string != '\0') {
+        *position++ = *string++;
+    }
+    *position = '\0';
+    return position;
+}
+
+/**
+ * Writes the digits of a value from the lowest one into a buffer and copies them in reverse order.
+ */
+static char* kernelBenchmark_putValue(char* position, uint32_t value) {
+    char digits[10];
+    unsigned int count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while(value > 0);
+    while(count > 0) {
+        *position++ = digits[--count];
+    }
+    *position = '\0';
+    return position;
+}
+
+/**
+ * Takes the cycle count and switches to the other thread of the same priority. When this thread runs again, the other thread has done the same,
+ * so the cycles since its count are the cost of a single switch. The very first switch to a new thread is not measured.
+ */
+static void kernelBenchmark_switchThread(void) {
+    while(gRemaining > 0) {
+        gSwitchStart = port_getCycles();
+        scheduler_runNextThread();
+        if(gRemaining > 0) {
+            kernelBenchmark_addSample(&gSamples[0], (PortCycles_t)(port_getCycles() - gSwitchStart));
+            gRemaining--;
+        }
+    }
+    semaphor_V(&gDone);
+}
+
+/**
+ * Releases the pong thread and waits for its answer. The ping pong threads have the same priority, so every round trip blocks each of them once.
+ */
+static void kernelBenchmark_pingThread(void) {
+    while(gRemaining > 0) {
+        PortCycles_t start = port_getCycles();
+        semaphor_V(&gPing);
+        semaphor_P(&gPong);
+        kernelBenchmark_addSample(&gSamples[0], (PortCycles_t)(port_getCycles() - start));
+        gRemaining--;
+    }
+    semaphor_V(&gPing);                                                 //Releases the pong thread a last time, so it can finish
+    semaphor_V(&gDone);
+}
+
+/**
+ * Answers every ping until the ping thread is finished.
+ */
+static void kernelBenchmark_pongThread(void) {
+    while(1) {
+        semaphor_P(&gPing);
+        if(gRemaining == 0) {
+            break;
+        }
+        semaphor_V(&gPong);
+    }
+    semaphor_V(&gDone);
+}
+
+/**
+ * Measures the duration of every sleep. The wake-up latency of the same sleep is taken from the runtime statistics of the thread,
+ * which the scheduler updates on the switch to a resumed thread, and is added to the second set of samples. A first short sleep
+ * aligns the thread to the system tick.
+ */
+static void kernelBenchmark_sleepThread(void) {
+#if THREAD_STATISTICS
+    ThreadStatistics_t statistics;
+    ThreadID_t self = scheduler_getRunningThread();
+    uint32_t latencyTotal;
+#endif
+
+    scheduler_threadSleep(1);
+#if THREAD_STATISTICS
+    scheduler_getStatistics(self, &statistics);
+    latencyTotal = statistics.wakeLatencyTotal;
+#endif
+    while(gRemaining > 0) {
+        uint32_t start = port_getTimestamp();
+        scheduler_threadSleep(KERNELBENCHMARK_SLEEP_TIME);
+        kernelBenchmark_addSample(&gSamples[0], port_getTimestamp() - start);
+#if THREAD_STATISTICS
+        scheduler_getStatistics(self, &statistics);
+        kernelBenchmark_addSample(&gSamples[1], statistics.wakeLatencyTotal - latencyTotal);
+        latencyTotal = statistics.wakeLatencyTotal;
+#endif
+        gRemaining--;
+    }
+    semaphor_V(&gDone);
+}
+
+/**
+ * Switches to a second context on the own stack and back, first with port_switchContext and afterwards with setjmp/longjmp. The scheduler is not
+ * involved and global interrupts stay disabled, so the samples only contain the switches themselves. The first switch of each method starts
+ * the second context and is not measured. The lower half of the memory is the stack of the second context. The upper half holds a context
+ * for this thread, because a port may save a context only into one that has been initialized, like the ucontext_t on Linux.
+ */
+static void kernelBenchmark_rawSwitchThread(void) {
+    uint16_t memory[KERNELBENCHMARK_RAW_MEMORY_SIZE / sizeof(uint16_t)];
+    unsigned short s;
+    uint16_t i;
+
+    ATOMIC_START(s);
+    gRawSetjmp = 0;
+    port_initContext(&gRawContext, (uint8_t*)memory, sizeof(memory) / 2, &kernelBenchmark_rawEntry);
+    port_initContext(&gThreadContext, (uint8_t*)memory + sizeof(memory) / 2, sizeof(memory) / 2, &kernelBenchmark_rawEntry);
+    port_switchContext(&gThreadContext, gRawContext);
+    for(i = 0; i < gRemaining; i++) {
+        PortCycles_t start = port_getCycles();
+        port_switchContext(&gThreadContext, gRawContext);
+        kernelBenchmark_addSample(&gSamples[0], (PortCycles_t)(port_getCycles() - start));
+    }
+
+    gRawSetjmp = 1;
+    port_switchContext(&gThreadContext, gRawContext);
+    for(i = 0; i < gRemaining; i++) {
+        PortCycles_t start = port_getCycles();
+        if(setjmp(gThreadJump) == 0) {
+            longjmp(gRawJump, 1);
+        }
+        kernelBenchmark_addSample(&gSamples[1], (PortCycles_t)(port_getCycles() - start));
+    }
+    ATOMIC_END(s);
+    semaphor_V(&gDone);
+}
+
+/**
+ * Switches back with port_switchContext until the setjmp/longjmp benchmark starts. Then it saves its position with setjmp and switches back
+ * a last time with port_switchContext, afterwards every longjmp to it is answered with a longjmp back.
+ */
+static void kernelBenchmark_rawEntry(void) {
+    while(!gRawSetjmp) {
+        port_switchContext(&gRawContext, gThreadContext);
+    }
+    if(setjmp(gRawJump) == 0) {
+        port_switchContext(&gRawContext, gThreadContext);
+    }
+    while(1) {
+        if(setjmp(gRawJump) == 0) {
+            longjmp(gThreadJump, 1);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * kernelBenchmark.h
+ *
+ * This Headerfile defines the micro-benchmarks of the scheduler and the semaphor. Every benchmark measures KERNELBENCHMARK_ITERATIONS samples.
+ * Switches are measured with the cycle counter of the port, which counts CPU cycles on the launchpad and nanoseconds on Linux. Sleeps and wake-ups
+ * are measured with the timestamps of the port, because the cycle counter may stop while the CPU is idle. Every result carries the frequency of its
+ * unit, so the same benchmarks compare changes on the board and on a workstation.
+ *
+ */
+
+#ifndef KERNELBENCHMARK_H_
+#define KERNELBENCHMARK_H_
+
+#include "thread.h"
+
+#define KERNELBENCHMARK_ITERATIONS  1000                                //Defines the number of samples of every benchmark
+#define KERNELBENCHMARK_SLEEP_TIME  10                                  //Defines the system ticks the sleep benchmark sleeps per sample
+#define KERNELBENCHMARK_PRIORITY    THREAD_PRIORITY_HIGHEST             //Defines the priority of the benchmark threads, so other threads do not disturb them
+#ifndef KERNELBENCHMARK_STACK_SIZE
+#define KERNELBENCHMARK_STACK_SIZE  (PORT_STACK_ARENA_SIZE / THREADPOOL_SIZE)   //Defines the stack size of a benchmark thread. Stacks are reused by the following benchmarks
+#endif
+#define KERNELBENCHMARK_LINE_SIZE   128                                 //Defines the size of a buffer for a result formatted by kernelBenchmark_format, including the terminating zero
+
+typedef enum {                                                          //Defines the benchmarks in the order they are run
+    KERNELBENCHMARK_CONTEXT_SWITCH,                                     //Time from scheduler_runNextThread in one thread until the other thread of the same priority runs
+    KERNELBENCHMARK_SEMAPHOR_PINGPONG,                                  //Round trip of a semaphor_V/semaphor_P pair between two threads, which takes two switches
+    KERNELBENCHMARK_SLEEP,                                              //Duration of scheduler_threadSleep(KERNELBENCHMARK_SLEEP_TIME), the spread is the wake-up jitter
+    KERNELBENCHMARK_WAKEUP_LATENCY,                                     //Time from the resume of a sleeping thread in the timerCallback until it runs. Requires THREAD_STATISTICS
+    KERNELBENCHMARK_PORT_SWITCH,                                        //Round trip to a second context and back with port_switchContext, without the scheduler
+    KERNELBENCHMARK_SETJMP_SWITCH,                                      //The same round trip with setjmp/longjmp, which is how the scheduler switched before port_switchContext
+    KERNELBENCHMARK_COUNT
+} KernelBenchmark_t;
+
+typedef struct {                                                        //Defines the result of a benchmark
+    uint32_t min;
+    uint32_t mean;
+    uint32_t p99;                                                       //99th percentile, which is exceeded by 1% of the samples
+    uint32_t frequency;                                                 //Frequency of the unit of min, mean and p99 in Hz, PORT_CYCLE_FREQUENCY or PORT_TIMESTAMP_FREQUENCY
+    uint16_t count;                                                     //Number of samples, 0 if the benchmark could not be run
+} KernelBenchmarkResult_t;
+
+/**
+ * Runs every benchmark one after another and writes their results. The calling thread is blocked meanwhile. Returns 0 on success and -1
+ * if the benchmark threads could not be started.
+ */
+int kernelBenchmark_run(KernelBenchmarkResult_t results[KERNELBENCHMARK_COUNT]);
+
+/**
+ * Returns the name of a benchmark, which identifies its results in machine-readable output.
+ */
+const char* kernelBenchmark_getName(KernelBenchmark_t benchmark);
+
+/**
+ * Formats the result of a benchmark as one line of JSON with its name, min, mean, p99, count and frequency. The line ends with a newline and
+ * has to fit into KERNELBENCHMARK_LINE_SIZE bytes. Returns the number of characters written without the terminating zero.
+ */
+uint16_t kernelBenchmark_format(char* line, KernelBenchmark_t benchmark, const KernelBenchmarkResult_t* result);
+
+#endif /* KERNELBENCHMARK_H_ */
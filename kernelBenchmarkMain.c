@@ -0,0 +1,73 @@
+/**
+ * kernelBenchmarkMain.c
+ *
+ * This file implements the main entry point of the kernel benchmark target, which runs every benchmark of kernelBenchmark.h once and writes each
+ * result as one line of JSON. On the launchpad the lines are sent as text frames on the telemetry stream, which tools/telemetryDecoder.c writes
+ * line by line. The launchpad target is the "Benchmark" build configuration, which defines KERNELBENCHMARK_MAIN, so main.c is left out.
+ * On Linux the lines are written to stdout:
+ *
+ *  gcc -O2 -I. scheduler.c semaphor.c mutex.c trace.c kernelBenchmark.c kernelBenchmarkMain.c port/linux/port.c -o kernelBenchmark
+ *
+ */
+
+#if defined(KERNELBENCHMARK_MAIN) && (defined(__MSP430__) || defined(LAUNCHPAD_SIMULATOR))
+
+#include "drivers/launchpad.h"
+#include "scheduler.h"
+#include "kernelBenchmark.h"
+
+static KernelBenchmarkResult_t gResults[KERNELBENCHMARK_COUNT];         //Results and line are not on the stack of the main thread, which is only STACK_SIZE bytes
+static char gLine[KERNELBENCHMARK_LINE_SIZE];
+
+/**
+ * Main entry point of the benchmark and the main thread. The benchmarks run once, their results are sent as soon as the UART has room for them.
+ * Afterwards the main thread sleeps, so the CPU stays in low power mode.
+ */
+int main(void) {
+    unsigned int i;
+    launchpad_init();
+    scheduler_init();
+    __enable_interrupt();
+
+    kernelBenchmark_run(gResults);
+    for(i = 0; i < KERNELBENCHMARK_COUNT; i++) {
+        const char* text = gLine;
+        kernelBenchmark_format(gLine, (KernelBenchmark_t)i, &gResults[i]);
+        while(*text != '\0') {
+            text += launchpad_sendText(text);
+            if(*text != '\0') {
+                scheduler_threadSleep(1);                                   //Wait until the UART has sent some of the previous frames
+            }
+        }
+    }
+    while(1) {
+        scheduler_threadSleep(60000);
+    }
+}
+
+#elif defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <stdio.h>
+#include "scheduler.h"
+#include "kernelBenchmark.h"
+
+/**
+ * Main entry point of the benchmark on Linux. Returns 1 if a benchmark thread could not be started.
+ */
+int main(void) {
+    KernelBenchmarkResult_t results[KERNELBENCHMARK_COUNT];
+    char line[KERNELBENCHMARK_LINE_SIZE];
+    unsigned int i;
+    int err;
+
+    scheduler_init();
+    port_enableInterrupts();
+    err = kernelBenchmark_run(results);
+    for(i = 0; i < KERNELBENCHMARK_COUNT; i++) {
+        kernelBenchmark_format(line, (KernelBenchmark_t)i, &results[i]);
+        fputs(line, stdout);
+    }
+    return err == 0 ? 0 : 1;
+}
+
+#endif /* KERNELBENCHMARK_MAIN */
@@ -62,7 +62,8 @@ MEMORY
     INFOC                   : origin = 0x1880, length = 0x0080
     INFOD                   : origin = 0x1800, length = 0x0080
     FRAM                    : origin = 0x4400, length = 0xBB80
-    FRAM2                   : origin = 0x10000,length = 0x14000
+    FRAM2                   : origin = 0x10000,length = 0xC000
+    FRAMLOG                 : origin = 0x1C000,length = 0x8000
     JTAGSIGNATURE           : origin = 0xFF80, length = 0x0004, fill = 0xFFFF
     BSLSIGNATURE            : origin = 0xFF84, length = 0x0004, fill = 0xFFFF
     IPESIGNATURE            : origin = 0xFF88, length = 0x0008, fill = 0xFFFF
@@ -192,6 +193,8 @@ SECTIONS
     .stack      : {} > RAM (HIGH)           /* Software system stack             */
     .tinyram    : {} > TINYRAM              /* Tiny RAM                          */
 
+    .samplelog  : type = NOINIT {} > FRAMLOG, RUN_START(fram_log_start)  /* Persistent sample log, see sampleLog.h */
+
     .infoA (NOLOAD) : {} > INFOA              /* MSP430 INFO FRAM  Memory segments */
     .infoB (NOLOAD) : {} > INFOB
     .infoC (NOLOAD) : {} > INFOC
@@ -311,16 +314,16 @@ SECTIONS
       mpu_sam_value = (_MPU_SAM0 << 12) | (_MPU_SAM3 << 8) | (_MPU_SAM2 << 4) | _MPU_SAM1;
    #else // Automated sizes generated by Linker
       #ifdef _IPE_ENABLE //if IPE is used in project too
-         //seg1 = any read + write persistent variables
-         //seg2 = ipe = read + write + execute access
-         //seg3 = code, read + execute only
-         mpu_segment_border1 = fram_ipe_start >> 4;
-         mpu_segment_border2 = fram_rx_start >> 4;
-         mpu_sam_value = 0x1573; // Info R, Seg3 RX, Seg2 RWX, Seg1 RW
+         //The IPE takes the middle segment, so the sample log at the end of FRAM2 would share the read + execute only segment
+         //of the code and every append would cause a segment violation. Use manual MPU sizes to combine both.
+         #error "IPE with automated MPU sizes is not supported, the sample log needs a writable segment 3"
       #else
+         //seg1 = any read + write persistent variables
+         //seg2 = code, read + execute only
+         //seg3 = sample log, read + write
          mpu_segment_border1 = fram_rx_start >> 4;
-         mpu_segment_border2 = fram_rx_start >> 4;
-         mpu_sam_value = 0x1513; // Info R, Seg3 RX, Seg2 R, Seg1 RW
+         mpu_segment_border2 = fram_log_start >> 4;
+         mpu_sam_value = 0x1353; // Info R, Seg3 RW, Seg2 RX, Seg1 RW
       #endif
    #endif
    #ifdef _MPU_LOCK
@@ -2,13 +2,18 @@
  * main.c
  *
  * This file implements the main entry point of the program and some simple application logic.
- * All threads are implemented here.
+ * All threads and the jobs of the work queue are implemented here. The "Benchmark" build configuration defines KERNELBENCHMARK_MAIN and uses the main entry point of kernelBenchmarkMain.c instead.
  *
  */
 
+#if !defined(KERNELBENCHMARK_MAIN)
+
 #include "drivers/launchpad.h"
 #include "scheduler.h"
-#include "semaphor.h"
+#include "mutex.h"
+#include "sampleLog.h"
+#include "softTimer.h"
+#include "workQueue.h"
 
 typedef enum {                                              //Defines the different display modes to be shown on the display
     DISPLAYMODE_CELSIUS,
@@ -16,131 +21,132 @@ typedef enum {                                              //Defines the differ
 } DisplayMode_t;
 
 static DisplayMode_t displayMode;                           //Defines the currently active display mode
-static Semaphor_t btnSemaphor;                              //Defines the producer/consumer semaphor used for the button and switching of display modes
-static Semaphor_t tempSemaphor;                             //Defines the producer/consumer semaphor used for reading and displaying temperature
+static Mutex_t displayModeMutex;                            //Defines the mutex that protects the display mode
+static SoftTimer_t aliveTimer;                              //Defines the auto-reload timer that blinks the green LED
+static SoftTimer_t statisticsTimer;                         //Defines the auto-reload timer that sends the power statistics
 
 /**
- * This thread triggers a temperature measurement and releases the semaphor of the display thread afterwards.
+ * This thread triggers a temperature measurement and submits the bottom half of the result to the work queue afterwards.
  */
 static void readTempThread(void);
 
 /**
- * This thread blocks until there is a result of a temperature measurement. Afterwards it reads the current value,
- * converts it into the correct unit, depending on the display mode and shows it on the LCD screen.
+ * This job is the bottom half of a temperature measurement, which is executed by the worker. It appends the latest sample to the log, sends it on
+ * the telemetry stream, converts it into the correct unit, depending on the display mode and shows it on the LCD screen.
  */
-static void showTempThread(void);
+static void showTempJob(void* argument);
 
 /**
- * This thread listens for a button press and releases the semaphor of the button consumer thread if it detects one.
+ * This thread blocks until a button press is detected and if so switches the display mode.
  */
-static void buttonProducerThread(void);
+static void buttonConsumerThread(void);
 
 /**
- * This thread blocks until a button press is detected and if so switches the display mode.
+ * This timer callback periodically blinks the green LED to keep the application alive and show this as visual feedback.
  */
-static void buttonConsumerThread(void);
+static void aliveCallback(void* argument);
 
 /**
- * This thread periodically blinks the green LED to keep the application alive and show this as visual feedback.
+ * This timer callback periodically sends the power statistics on the telemetry stream.
  */
-static void aliveThread(void);
+static void statisticsCallback(void* argument);
 
 /**
  * Main entry point for the application and the main thread. Any module initializations are done here and also every thread is
- * started here.
+ * started here. Afterwards the main thread runs the timer service.
  */
 int main(void) {
     displayMode = DISPLAYMODE_CELSIUS;
     launchpad_init();
     scheduler_init();
+    sampleLog_init();
     __enable_interrupt();
 
-    semaphor_init(&tempSemaphor);
-    semaphor_init(&btnSemaphor);
-    scheduler_startThread(&readTempThread);
-    scheduler_startThread(&showTempThread);
-    scheduler_startThread(&buttonProducerThread);
-    scheduler_startThread(&buttonConsumerThread);
+    workQueue_init();
+    mutex_init(&displayModeMutex);
+    scheduler_startThread(&readTempThread, THREAD_PRIORITY_HIGH, 192);
+    scheduler_startThread(&workQueue_runWorker, THREAD_PRIORITY_NORMAL, 256);    //The worker executes the bottom halves, e.g. showTempJob
+    scheduler_startThread(&buttonConsumerThread, THREAD_PRIORITY_LOW, 128);
+
+    softTimer_init(&aliveTimer, &aliveCallback, NULL);
+    softTimer_start(&aliveTimer, 500, 500);
+    softTimer_init(&statisticsTimer, &statisticsCallback, NULL);
+    softTimer_start(&statisticsTimer, 10000, 10000);
 
-    aliveThread();
+    softTimer_runService();
 }
 
 /**
- * This thread triggers a temperature measurement and releases the semaphor of the display thread afterwards.
+ * This thread triggers a temperature measurement and submits the bottom half of the result to the work queue afterwards. The job gets the number
+ * of the sample, which the sensor driver keeps in its double buffer, instead of a copy of it.
  */
 static void readTempThread(void) {
     while(1) {
+        int16_t sensorValue;
+        TemperatureSample_t sample;
         launchpad_measureTemperature();
         scheduler_threadSleep(100);                     //Sleep to ensure the measurement is complete
-        semaphor_V(&tempSemaphor);                      //Produce for the display thread
+        if(launchpad_readTemperature(&sensorValue) == 0) {
+            uint16_t sequence = launchpad_getTemperatureSample(&sample);
+            workQueue_submit(&showTempJob, (void*)(uintptr_t)sequence);     //A rejected sample is dropped, the next one follows shortly
+        }
     }
 }
 
 /**
- * This thread blocks until there is a result of a temperature measurement. Afterwards it reads the current value,
- * converts it into the correct unit, depending on the display mode and shows it on the LCD screen.
+ * This job is the bottom half of a temperature measurement, which is executed by the worker. It appends the latest sample to the log, sends it on
+ * the telemetry stream, converts it into the correct unit, depending on the display mode and shows it on the LCD screen. If a newer sample
+ * has been published in the meantime, the job of that sample follows, so this one does nothing and no sample is handled twice.
  */
-static void showTempThread(void) {
-    while(1) {
-        semaphor_P(&tempSemaphor);                        //Block until a measurement happens.
-        int32_t sensorValue = launchpad_readTemperature();//Read the current temperature which should have been updated in a different thread.
-        sensorValue *= 17572;                             //Convert to C with one digit after comma multiplied by 10 (20,1 C = 201 here)
-        sensorValue /= 65536;
-        sensorValue -= 4685;
-        sensorValue /= 10;
-
-        switch (displayMode) {                          //Display C with the correct unit
-        case DISPLAYMODE_CELSIUS:
-            launchpad_showTemperature(sensorValue, CELSIUS);
-            break;
-        case DISPLAYMODE_FAHRENHEIT:                    //Convert to F and display with the correct unit
-            sensorValue *= 18;
-            sensorValue /= 10;
-            sensorValue += 320;
-            launchpad_showTemperature(sensorValue, FAHRENHEIT);
-            break;
-        default:                                        //Default do not display anything
-            launchpad_clearDisplay();
-            break;
-        }
+static void showTempJob(void* argument) {
+    TemperatureSample_t sample;
+    if(launchpad_getTemperatureSample(&sample) != (uint16_t)(uintptr_t)argument) {
+        return;
     }
+    sampleLog_append(sample.timestamp, sample.value);   //Keep the sample in the persistent log
+    launchpad_sendSample(&sample);                      //Stream the sample, it is dropped if the UART is busy
+
+    mutex_lock(&displayModeMutex);
+    switch (displayMode) {                              //Convert the value of exactly this measurement and display it with the correct unit
+    case DISPLAYMODE_CELSIUS:
+        launchpad_showSensorValue(sample.value, CELSIUS);
+        break;
+    case DISPLAYMODE_FAHRENHEIT:
+        launchpad_showSensorValue(sample.value, FAHRENHEIT);
+        break;
+    default:                                            //Default do not display anything
+        launchpad_clearDisplay();
+        break;
+    }
+    mutex_unlock(&displayModeMutex);
 }
 
 /**
- * This thread listens for a button press and releases the semaphor of the button consumer thread if it detects one.
- * Note: The button does not work 100% reliable, but for this application it is sufficient.
+ * This thread blocks until a button press is detected and if so switches the display mode.
  */
-static void buttonProducerThread(void) {
-    static unsigned char oldBtnState = BTN_SHIFT;
-
+static void buttonConsumerThread(void) {
     while(1) {
-        unsigned char btnState = launchpad_getButtonState();
-        if(btnState != oldBtnState) {
-            if(btnState == 0) {
-                semaphor_V(&btnSemaphor);
-            }
-            oldBtnState = btnState;
+        if(launchpad_waitButtonEvent() != BUTTON_EVENT_PRESS) {   //Block until the button driver posts an event
+            continue;
         }
-        scheduler_threadSleep(BTN_DEBOUNCE_TIME);
+        mutex_lock(&displayModeMutex);
+        displayMode = displayMode == DISPLAYMODE_CELSIUS ? DISPLAYMODE_FAHRENHEIT : DISPLAYMODE_CELSIUS;
+        mutex_unlock(&displayModeMutex);
     }
 }
 
 /**
- * This thread blocks until a button press is detected and if so switches the display mode.
+ * This timer callback periodically blinks the green LED to keep the application alive and show this as visual feedback.
  */
-static void buttonConsumerThread(void) {
-    while(1) {
-        semaphor_P(&btnSemaphor);
-        displayMode = displayMode == DISPLAYMODE_CELSIUS ? DISPLAYMODE_FAHRENHEIT : DISPLAYMODE_CELSIUS;
-    }
+static void aliveCallback(void* argument) {
+    launchpad_toggleGreenLED();
 }
 
 /**
- * This thread periodically blinks the green LED to keep the application alive and show this as visual feedback.
+ * This timer callback periodically sends the power statistics on the telemetry stream.
  */
-static void aliveThread(void) {
-    while(1) {
-        launchpad_toggleGreenLED();
-        scheduler_threadSleep(500);
-    }
+static void statisticsCallback(void* argument) {
+    launchpad_sendPowerStatistics();
 }
+
+#endif /* KERNELBENCHMARK_MAIN */
@@ -0,0 +1,135 @@
+/**
+ * messageQueue.c
+ *
+ * This file contains the implementation of the functionality declared in messageQueue.h.
+ *
+ */
+
+#include <string.h>
+#include "scheduler.h"
+#include "messageQueue.h"
+#include "port/port.h"
+
+/**
+ * Copies a message to the write position of the ring buffer and resumes a waiting receiver.
+ */
+static inline void messageQueue_put(MessageQueue_t* queue, const void* message);
+
+/**
+ * Copies the message at the read position of the ring buffer and resumes a waiting sender.
+ */
+static inline void messageQueue_get(MessageQueue_t* queue, void* message);
+
+/**
+ * Initializes an empty message queue, which uses the specified buffer for capacity messages of messageSize bytes.
+ */
+void messageQueue_init(MessageQueue_t* queue, void* buffer, size_t messageSize, unsigned int capacity) {
+    queue->buffer = buffer;
+    queue->messageSize = messageSize;
+    queue->capacity = capacity;
+    queue->count = 0;
+    queue->readIndex = 0;
+    queue->writeIndex = 0;
+    scheduler_initQueue(&queue->senders, THREADQUEUE_FIFO);
+    scheduler_initQueue(&queue->receivers, THREADQUEUE_FIFO);
+}
+
+/**
+ * Copies a message into the queue. This is an atomic function which blocks the current thread while the queue is full.
+ * A resumed sender checks again, because an interrupt may have filled the queue in the meantime.
+ */
+void messageQueue_send(MessageQueue_t* queue, const void* message) {
+    unsigned short s;
+    ATOMIC_START(s);
+    while(queue->count == queue->capacity) {
+        scheduler_blockThreadInQueue(&queue->senders);
+    }
+    messageQueue_put(queue, message);
+    ATOMIC_END(s);
+}
+
+/**
+ * Copies a message into the queue without blocking. This is an atomic function, which may also be called from an interrupt.
+ * On the MSP430 the interrupt has to leave low power mode on exit, so a resumed receiver can run.
+ */
+int messageQueue_trySend(MessageQueue_t* queue, const void* message) {
+    unsigned short s;
+    int err = 0;
+    ATOMIC_START(s);
+    if(queue->count == queue->capacity) {
+        err = -1;
+    } else {
+        messageQueue_put(queue, message);
+    }
+    ATOMIC_END(s);
+    return err;
+}
+
+/**
+ * Copies the oldest message out of the queue. This is an atomic function which blocks the current thread while the queue is empty.
+ */
+void messageQueue_receive(MessageQueue_t* queue, void* message) {
+    unsigned short s;
+    ATOMIC_START(s);
+    while(queue->count == 0) {
+        scheduler_blockThreadInQueue(&queue->receivers);
+    }
+    messageQueue_get(queue, message);
+    ATOMIC_END(s);
+}
+
+/**
+ * Copies the oldest message out of the queue without blocking. This is an atomic function.
+ */
+int messageQueue_tryReceive(MessageQueue_t* queue, void* message) {
+    unsigned short s;
+    int err = 0;
+    ATOMIC_START(s);
+    if(queue->count == 0) {
+        err = -1;
+    } else {
+        messageQueue_get(queue, message);
+    }
+    ATOMIC_END(s);
+    return err;
+}
+
+/**
+ * Sends a pointer to a buffer. Only the pointer is copied into the queue, the receiver owns the buffer afterwards.
+ */
+void messageQueue_sendPointer(MessageQueue_t* queue, void* pointer) {
+    messageQueue_send(queue, &pointer);
+}
+
+/**
+ * Receives a pointer to a buffer, which has been sent with messageQueue_sendPointer.
+ */
+void* messageQueue_receivePointer(MessageQueue_t* queue) {
+    void* pointer;
+    messageQueue_receive(queue, &pointer);
+    return pointer;
+}
+
+/**
+ * Copies a message to the write position of the ring buffer and resumes the first waiting receiver, if there is any.
+ */
+static inline void messageQueue_put(MessageQueue_t* queue, const void* message) {
+    memcpy(queue->buffer + queue->writeIndex * queue->messageSize, message, queue->messageSize);
+    if(++queue->writeIndex == queue->capacity) {
+        queue->writeIndex = 0;
+    }
+    queue->count++;
+    scheduler_resumeQueuedThread(&queue->receivers);
+}
+
+/**
+ * Copies the message at the read position of the ring buffer and resumes the first waiting sender, if there is any.
+ */
+static inline void messageQueue_get(MessageQueue_t* queue, void* message) {
+    memcpy(message, queue->buffer + queue->readIndex * queue->messageSize, queue->messageSize);
+    if(++queue->readIndex == queue->capacity) {
+        queue->readIndex = 0;
+    }
+    queue->count--;
+    scheduler_resumeQueuedThread(&queue->senders);
+}
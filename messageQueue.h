@@ -0,0 +1,62 @@
+/**
+ * messageQueue.h
+ *
+ * This Headerfile defines the basic structure and functions of a bounded message queue. Messages of a fixed size are copied into a ring buffer,
+ * which is provided by the user. Larger buffers can be passed without copying by sending pointers to them.
+ *
+ */
+
+
+#ifndef MESSAGEQUEUE_H_
+#define MESSAGEQUEUE_H_
+
+#include <stddef.h>
+#include "thread.h"
+
+typedef struct {                        //Defines the control block of a message queue
+    uint8_t* buffer;
+    size_t messageSize;
+    unsigned int capacity;
+    unsigned int count;
+    unsigned int readIndex;
+    unsigned int writeIndex;
+    ThreadQueue_t senders;
+    ThreadQueue_t receivers;
+} MessageQueue_t;
+
+/**
+ * Initializer function for a message queue. The buffer has to be able to hold capacity messages of messageSize bytes each.
+ */
+void messageQueue_init(MessageQueue_t* queue, void* buffer, size_t messageSize, unsigned int capacity);
+
+/**
+ * Copies a message into the queue. Blocks while the queue is full.
+ */
+void messageQueue_send(MessageQueue_t* queue, const void* message);
+
+/**
+ * Copies a message into the queue without blocking, so it can be called from an interrupt. Returns -1 if the queue is full.
+ */
+int messageQueue_trySend(MessageQueue_t* queue, const void* message);
+
+/**
+ * Copies the oldest message out of the queue. Blocks while the queue is empty.
+ */
+void messageQueue_receive(MessageQueue_t* queue, void* message);
+
+/**
+ * Copies the oldest message out of the queue without blocking. Returns -1 if the queue is empty.
+ */
+int messageQueue_tryReceive(MessageQueue_t* queue, void* message);
+
+/**
+ * Sends a pointer to a buffer without copying the buffer itself. The queue has to be initialized with a messageSize of sizeof(void*).
+ */
+void messageQueue_sendPointer(MessageQueue_t* queue, void* pointer);
+
+/**
+ * Receives a pointer to a buffer, which has been sent with messageQueue_sendPointer. Blocks while the queue is empty.
+ */
+void* messageQueue_receivePointer(MessageQueue_t* queue);
+
+#endif /* MESSAGEQUEUE_H_ */
@@ -0,0 +1,134 @@
+/**
+ * mutex.c
+ *
+ * This file contains the implementation of the functionality declared in mutex.h.
+ *
+ * Priority inheritance: A thread that blocks on a mutex raises the priority of the owner to its own priority. If the owner is blocked
+ * on another mutex itself, the priority is passed on along the chain of owners. A thread gets back the priority it had before locking
+ * its first mutex as soon as it does not hold any mutex anymore. Until then it keeps the highest inherited priority, which is simple
+ * and still bounds the inversion by the longest critical section.
+ *
+ */
+
+#include "scheduler.h"
+#include "mutex.h"
+#include "port/port.h"
+
+static Mutex_t* gBlockingMutex[THREADPOOL_SIZE];                    //The mutex every thread is currently waiting for, NULL if it is not waiting
+static unsigned char gHeldMutexes[THREADPOOL_SIZE];                 //Number of mutexes every thread currently holds
+static ThreadPriority_t gBasePriority[THREADPOOL_SIZE];             //Priority of every thread before it locked its first mutex
+
+/**
+ * Passes the priority of a blocking thread on to the owner of the mutex and along the chain of owners blocked on further mutexes.
+ */
+static void mutex_inheritPriority(Mutex_t* mutex, ThreadPriority_t priority);
+
+/**
+ * Makes a thread the owner of a mutex.
+ */
+static inline void mutex_take(Mutex_t* mutex, ThreadID_t id);
+
+/**
+ * Initializes a mutex without an owner and with an empty queue. Waiting threads are ordered by priority.
+ */
+void mutex_init(Mutex_t* mutex) {
+    mutex->owner = THREAD_ID_INVALID;
+    mutex->lockCount = 0;
+    scheduler_initQueue(&mutex->queue, THREADQUEUE_PRIORITY);
+}
+
+/**
+ * Locking function for a mutex. This is an atomic function. If the mutex is free or already owned by the current thread, it is taken without
+ * involving the scheduler. Otherwise the owner inherits the priority of the current thread, which blocks until the mutex is handed over to it.
+ */
+void mutex_lock(Mutex_t* mutex) {
+    unsigned short s;
+    ATOMIC_START(s);
+    ThreadID_t id = scheduler_getRunningThread();
+    if(mutex->owner == THREAD_ID_INVALID) {
+        mutex_take(mutex, id);
+    } else if(mutex->owner == id) {
+        mutex->lockCount++;
+    } else {
+        gBlockingMutex[id] = mutex;
+        mutex_inheritPriority(mutex, scheduler_getPriority(id));
+        scheduler_blockThreadInQueue(&mutex->queue);                //The mutex_unlock of the owner hands the mutex over before resuming this thread
+    }
+    ATOMIC_END(s);
+}
+
+/**
+ * Unlocking function for a mutex. This is an atomic function. After the last unlock the owner returns to its base priority if it does not hold
+ * any other mutex. The mutex is handed over to the waiting thread with the highest priority. If the current thread lost an inherited priority
+ * or the new owner has a higher priority, the scheduler is called right away. Without an inherited priority and without a waiting thread,
+ * the scheduler is not involved at all, which keeps the uncontended unlock cheaper than a semaphor_V.
+ */
+int mutex_unlock(Mutex_t* mutex) {
+    unsigned short s;
+    ATOMIC_START(s);
+    ThreadID_t id = scheduler_getRunningThread();
+    if(mutex->owner != id) {
+        ATOMIC_END(s);
+        return -1;
+    }
+
+    if(--mutex->lockCount == 0) {
+        ThreadPriority_t priority = scheduler_getPriority(id);
+        ThreadID_t next = THREAD_ID_INVALID;
+        if(--gHeldMutexes[id] == 0 && gBasePriority[id] != priority) {
+            scheduler_setPriority(id, gBasePriority[id]);
+        }
+
+        if(mutex->queue.head == THREAD_ID_INVALID) {
+            mutex->owner = THREAD_ID_INVALID;
+        } else {
+            next = scheduler_resumeQueuedThread(&mutex->queue);
+            gBlockingMutex[next] = NULL;
+            mutex_take(mutex, next);
+            if(mutex->queue.head != THREAD_ID_INVALID) {            //The new owner inherits the priority of the remaining waiting threads
+                mutex_inheritPriority(mutex, scheduler_getPriority(mutex->queue.head));
+            }
+        }
+        if(scheduler_getPriority(id) < priority || (next != THREAD_ID_INVALID && scheduler_getPriority(next) > priority)) {
+            scheduler_runNextThread();                              //A thread of a higher priority may be ready now
+        }
+    }
+    ATOMIC_END(s);
+    return 0;
+}
+
+/**
+ * Resets the mutex bookkeeping of a slot of the threadpool. A thread, which terminated while holding a mutex, would otherwise leave its count
+ * to the next thread in the slot, which then would never get back its base priority.
+ */
+void mutex_initThread(ThreadID_t id) {
+    gBlockingMutex[id] = NULL;
+    gHeldMutexes[id] = 0;
+    gBasePriority[id] = 0;
+}
+
+/**
+ * Passes the priority on to the owner of the mutex. If the owner is blocked on another mutex, its position in the queue of that mutex
+ * is updated and the priority is passed on to the next owner, until an owner already has at least this priority.
+ */
+static void mutex_inheritPriority(Mutex_t* mutex, ThreadPriority_t priority) {
+    while(mutex != NULL && scheduler_getPriority(mutex->owner) < priority) {
+        ThreadID_t owner = mutex->owner;
+        scheduler_setPriority(owner, priority);
+        mutex = gBlockingMutex[owner];
+        if(mutex != NULL) {
+            scheduler_reorderQueuedThread(&mutex->queue, owner);
+        }
+    }
+}
+
+/**
+ * Makes a thread the owner of a mutex. The priority of the thread is remembered if this is the first mutex it holds.
+ */
+static inline void mutex_take(Mutex_t* mutex, ThreadID_t id) {
+    mutex->owner = id;
+    mutex->lockCount = 1;
+    if(gHeldMutexes[id]++ == 0) {
+        gBasePriority[id] = scheduler_getPriority(id);
+    }
+}
@@ -0,0 +1,41 @@
+/**
+ * mutex.h
+ *
+ * This Headerfile defines the basic structure and functions of a mutex. In contrast to a semaphor, a mutex has an owner, can be locked
+ * recursively by its owner and prevents priority inversion by priority inheritance.
+ *
+ */
+
+
+#ifndef MUTEX_H_
+#define MUTEX_H_
+
+#include "thread.h"
+
+typedef struct {                        //Defines the control block of a mutex
+    ThreadID_t owner;
+    unsigned int lockCount;
+    ThreadQueue_t queue;
+} Mutex_t;
+
+/**
+ * Initializer function for a mutex.
+ */
+void mutex_init(Mutex_t* mutex);
+
+/**
+ * Locking function for a mutex. Blocks until the mutex is available and may be called recursively by the owner.
+ */
+void mutex_lock(Mutex_t* mutex);
+
+/**
+ * Unlocking function for a mutex. Every mutex_lock of the owner requires one mutex_unlock. Returns -1 if the current thread is not the owner.
+ */
+int mutex_unlock(Mutex_t* mutex);
+
+/**
+ * Resets the mutex bookkeeping of a slot of the threadpool. This is called by the scheduler for every new thread.
+ */
+void mutex_initThread(ThreadID_t id);
+
+#endif /* MUTEX_H_ */
@@ -0,0 +1,257 @@
+/**
+ * port.c
+ *
+ * This file implements port.h for Linux, so the kernel can be built and profiled as a normal executable on a workstation.
+ * Threads are switched with ucontext and the system tick is derived from the monotonic clock. The timer interrupt is emulated with SIGALRM,
+ * which is only handled while the emulated global interrupts are enabled and deferred otherwise.
+ *
+ * Note: A thread can be interrupted and switched anywhere, just like on the MSP430. Threads should therefore call C library functions
+ * that are not async-signal-safe (printf, malloc, ...) only within ATOMIC_START/ATOMIC_END.
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include "../port.h"
+
+uint8_t gPortStackArena[PORT_STACK_ARENA_SIZE] __attribute__((aligned(PORT_STACK_ALIGNMENT)));
+
+static ucontext_t gMainContext;                                             //Context of the main thread, which does not run on a stack of the arena
+static volatile sig_atomic_t gInterruptsEnabled = 1;                        //Emulated global interrupt enable flag
+static volatile sig_atomic_t gTimerPending = 0;                             //Set if the timer signal arrived while interrupts were disabled
+static volatile sig_atomic_t gSwitchPending = 0;                            //Set while a requested switch waits for interrupts to be enabled
+static uint32_t gLastCallbackTicks = 0;                                     //System ticks at the last execution of the timerCallback
+static unsigned char gTimerInitialized = 0;                                 //Set after the signal handler has been installed
+
+/**
+ * Handles an expired deadline like the timer interrupt of the MSP430 and executes the timerCallback.
+ */
+static void port_handleTimer(void);
+
+/**
+ * Executes the switchCallback for a pending switch request like the switch interrupt of the MSP430.
+ */
+static void port_handleSwitch(void);
+
+/**
+ * Signal handler of SIGALRM, which either handles the timer or defers it until interrupts are enabled again.
+ */
+static void port_timerSignal(int signal);
+
+/**
+ * Installs the signal handler of SIGALRM on first use.
+ */
+static void port_initTimer(void);
+
+/**
+ * Places the ucontext_t of the new thread at the upper end of its stack and uses the remaining stack for the thread itself.
+ */
+void port_initContext(PortContext_t* context, uint8_t* stackBase, size_t stackSize, PortEntry_t entry) {
+    ucontext_t* uc = (ucontext_t*)(((uintptr_t)(stackBase + stackSize) - sizeof(ucontext_t)) & ~(uintptr_t)(PORT_STACK_ALIGNMENT - 1));
+
+    getcontext(uc);
+    uc->uc_stack.ss_sp = stackBase;
+    uc->uc_stack.ss_size = (uint8_t*)uc - (uint8_t*)uc->uc_stack.ss_sp;
+    uc->uc_link = NULL;
+    sigemptyset(&uc->uc_sigmask);
+    makecontext(uc, entry, 0);
+    *context = uc;
+}
+
+/**
+ * Saves the running thread into from and continues with the thread saved in to. The main thread has no context of its own until its first switch.
+ */
+void port_switchContext(PortContext_t* from, PortContext_t to) {
+    if(*from == NULL) {
+        *from = &gMainContext;
+    }
+    swapcontext((ucontext_t*)*from, (ucontext_t*)to);
+}
+
+/**
+ * Enables the emulated global interrupts.
+ */
+void port_enableInterrupts(void) {
+    port_restoreInterrupts(1);
+}
+
+/**
+ * Disables the emulated global interrupts and returns the previous interrupt state.
+ */
+unsigned short port_disableInterrupts(void) {
+    unsigned short state = gInterruptsEnabled;
+    gInterruptsEnabled = 0;
+    return state;
+}
+
+/**
+ * Restores the emulated global interrupts to the specified state. A timer signal that arrived in between and a requested switch are handled now,
+ * just like pending interrupts on the MSP430.
+ */
+void port_restoreInterrupts(unsigned short state) {
+    gInterruptsEnabled = state;
+    if(state && gTimerPending) {
+        gTimerPending = 0;
+        port_handleTimer();
+    }
+    if(state && gSwitchPending) {
+        port_handleSwitch();
+    }
+}
+
+/**
+ * Marks a switch as pending. It is handled when the emulated global interrupts are enabled again.
+ */
+void port_requestSwitch(void) {
+    gSwitchPending = 1;
+}
+
+/**
+ * Returns the milliseconds passed since the first call by reading the monotonic clock.
+ */
+uint32_t port_getSystemTicks(void) {
+    static struct timespec start;
+    struct timespec now;
+
+    if(start.tv_sec == 0 && start.tv_nsec == 0) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+}
+
+/**
+ * Returns the microseconds of the monotonic clock. The timestamp overflows after approx. 71 minutes.
+ */
+uint32_t port_getTimestamp(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000 + now.tv_nsec / 1000);
+}
+
+/**
+ * Returns the timestamp, which is exact on Linux.
+ */
+uint32_t port_getRawTimestamp(void) {
+    return port_getTimestamp();
+}
+
+/**
+ * Returns the nanoseconds of the monotonic clock, which is the finest clock of the host.
+ */
+PortCycles_t port_getCycles(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (PortCycles_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+
+/**
+ * Requests SIGALRM at the specified absolute system tick. Deadlines that have already passed are signalled on the next tick.
+ */
+void port_setTimerDeadline(uint32_t deadline) {
+    struct itimerval timer;
+    int32_t interval = deadline - port_getSystemTicks();
+
+    port_initTimer();
+    if(interval > PORT_TIMER_MAX_INTERVAL) {
+        interval = PORT_TIMER_MAX_INTERVAL;
+    }
+    if(interval < 1) {
+        interval = 1;
+    }
+
+    memset(&timer, 0, sizeof(timer));
+    timer.it_value.tv_sec = interval / 1000;
+    timer.it_value.tv_usec = (interval % 1000) * 1000;
+    setitimer(ITIMER_REAL, &timer, NULL);
+}
+
+/**
+ * Waits for the next signal with the emulated global interrupts enabled. SIGALRM is blocked while checking for a deferred timer,
+ * so a signal cannot get lost between the check and the wait.
+ */
+void port_idle(void) {
+    sigset_t alarm;
+    sigset_t previous;
+
+    port_initTimer();
+    sigemptyset(&alarm);
+    sigaddset(&alarm, SIGALRM);
+    sigprocmask(SIG_BLOCK, &alarm, &previous);
+    gInterruptsEnabled = 1;
+    if(!gTimerPending) {
+        sigsuspend(&previous);
+    }
+    sigprocmask(SIG_SETMASK, &previous, NULL);
+    if(gTimerPending) {
+        gTimerPending = 0;
+        port_handleTimer();
+    }
+    gInterruptsEnabled = 0;
+}
+
+/**
+ * Handles an expired deadline like the timer interrupt of the MSP430. Interrupts are disabled while the timerCallback is executed.
+ * A switch requested by the timerCallback is handled right after it, like the switch interrupt follows the timer interrupt on the MSP430.
+ */
+static void port_handleTimer(void) {
+    uint32_t now = port_getSystemTicks();
+    uint16_t elapsed = (uint16_t)(now - gLastCallbackTicks);
+
+    gLastCallbackTicks = now;
+    gInterruptsEnabled = 0;
+    timerCallback(elapsed);
+    gInterruptsEnabled = 1;
+    if(gSwitchPending) {
+        port_handleSwitch();
+    }
+}
+
+/**
+ * Handles a requested switch with interrupts disabled. The switchCallback may switch to a different thread, the interrupted thread continues
+ * with interrupts enabled when it is switched back.
+ */
+static void port_handleSwitch(void) {
+    gSwitchPending = 0;
+    gInterruptsEnabled = 0;
+    switchCallback();
+    gInterruptsEnabled = 1;
+}
+
+/**
+ * Signal handler of SIGALRM. The timer is handled right away if the emulated global interrupts are enabled, otherwise it is deferred.
+ */
+static void port_timerSignal(int signal) {
+    (void)signal;
+    if(gInterruptsEnabled) {
+        port_handleTimer();
+    } else {
+        gTimerPending = 1;
+    }
+}
+
+/**
+ * Installs the signal handler of SIGALRM on first use. The handler may switch to a different thread, so it must not be reset on execution.
+ */
+static void port_initTimer(void) {
+    struct sigaction action;
+
+    if(gTimerInitialized) {
+        return;
+    }
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &port_timerSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &action, NULL);
+    gLastCallbackTicks = port_getSystemTicks();
+    gTimerInitialized = 1;
+}
+
+#endif /* __linux__ */
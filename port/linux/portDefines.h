@@ -0,0 +1,42 @@
+/**
+ * portDefines.h
+ *
+ * This Headerfile defines the Linux specific constants and macros required by port.h. Global interrupts are emulated with a flag that defers
+ * the timer signal, so an atomic section does not need a system call.
+ *
+ */
+
+#ifndef PORT_LINUX_PORTDEFINES_H_
+#define PORT_LINUX_PORTDEFINES_H_
+
+#include <inttypes.h>
+
+#ifndef THREADPOOL_SIZE
+#define THREADPOOL_SIZE             16                                                      //Defines the size of the threadpool, which limits how many concurrent threads can run
+#endif
+#define PORT_STACK_ARENA            gPortStackArena                                         //Defines the memory from which the stacks of the threads are carved
+#define PORT_STACK_ARENA_SIZE       (THREADPOOL_SIZE * 65536UL)                             //Defines the size of the stack arena in bytes. The C library requires a lot more stack than the MSP430
+#define PORT_STACK_ALIGNMENT        16                                                      //Defines the alignment of every stack in bytes as required by the x86-64 and AArch64 ABIs
+#define PORT_TIMER_INTERVAL         50                                                      //Defines the duration of a time slice in system ticks
+#define PORT_TIMER_MAX_INTERVAL     511                                                     //Defines the maximum number of system ticks between two timer interrupts
+#define PORT_TIMESTAMP_FREQUENCY    1000000UL                                               //Defines the frequency of the timestamps in Hz, which are microseconds
+#define PORT_CYCLE_FREQUENCY        1000000000UL                                            //Defines the frequency of the cycle counter in Hz, which counts nanoseconds
+
+#define ATOMIC_START(x)             x = port_disableInterrupts();                           //Disables the emulated global interrupts and saves the interrupt state to a variable
+#define ATOMIC_END(x)               port_restoreInterrupts(x);                              //Restores the emulated global interrupts and handles a deferred timer signal
+
+typedef uint32_t PortCycles_t;                                                              //Defines the range of the cycle counter, which wraps after approx. 4 seconds
+
+extern uint8_t gPortStackArena[PORT_STACK_ARENA_SIZE];                    //Memory, which is divided into the stacks of the threads
+
+/**
+ * Disables the emulated global interrupts and returns the previous interrupt state.
+ */
+unsigned short port_disableInterrupts(void);
+
+/**
+ * Restores the emulated global interrupts to the specified state. A timer signal that arrived in between is handled now.
+ */
+void port_restoreInterrupts(unsigned short state);
+
+#endif /* PORT_LINUX_PORTDEFINES_H_ */
@@ -0,0 +1,93 @@
+/**
+ * port.c
+ *
+ * This file implements the MSP430X specific part of port.h. The context switch itself is implemented in "portSwitch.asm", because it has to
+ * manipulate the stack pointer directly. This file builds the initial stack frame for new threads and delegates the timer related functionality
+ * to the launchpad.
+ *
+ */
+
+#include "../port.h"
+
+#define PORT_SAVED_REGISTERS        7                                   //Number of callee-saved registers (R4 - R10) that are pushed by port_switchContext
+
+uint16_t gPortStackArena[STACK_ARENA_SIZE / 2];                         //Memory, which is divided into the stacks of the threads
+
+/**
+ * Prepares the stack of a new thread below the upper end of its stack. The frame looks exactly like the one port_switchContext leaves behind:
+ * The return address points to the entry function and is followed by the saved registers, which are all initialized with 0.
+ * Every register is saved with 20 bit, which takes two words on the stack.
+ */
+void port_initContext(PortContext_t* context, uint8_t* stackBase, size_t stackSize, PortEntry_t entry) {
+    uint16_t* sp = (uint16_t*)(stackBase + stackSize);
+    unsigned int i;
+
+#if defined(__LARGE_CODE_MODEL__)
+    *--sp = (uint16_t)((uint32_t)entry >> 16);                          //RETA pops the upper 4 bit of the return address from the higher word
+    *--sp = (uint16_t)((uint32_t)entry);
+#else
+    *--sp = (uint16_t)(uintptr_t)entry;
+#endif
+
+    for(i = 0; i < PORT_SAVED_REGISTERS * 2; i++) {
+        *--sp = 0;
+    }
+
+    *context = sp;
+}
+
+/**
+ * Enables global interrupts.
+ */
+void port_enableInterrupts(void) {
+    __enable_interrupt();
+}
+
+/**
+ * Returns the current system ticks by delegating to the launchpad.
+ */
+uint32_t port_getSystemTicks(void) {
+    return launchpad_getSystemTicks();
+}
+
+/**
+ * Returns a timestamp in counts of TimerA0 by delegating to the launchpad.
+ */
+uint32_t port_getTimestamp(void) {
+    return launchpad_getTimestamp();
+}
+
+/**
+ * Returns the count of TimerA0 together with its epoch by delegating to the launchpad.
+ */
+uint32_t port_getRawTimestamp(void) {
+    return launchpad_getRawTimestamp();
+}
+
+/**
+ * Returns the cycle counter in counts of TimerA1 by delegating to the launchpad.
+ */
+PortCycles_t port_getCycles(void) {
+    return launchpad_getCycleCount();
+}
+
+/**
+ * Requests the execution of the timerCallback at the specified absolute system tick by delegating to the launchpad.
+ */
+void port_setTimerDeadline(uint32_t deadline) {
+    launchpad_setTimerDeadline(deadline);
+}
+
+/**
+ * Requests a deferred switch by delegating to the launchpad, which triggers a software interrupt.
+ */
+void port_requestSwitch(void) {
+    launchpad_requestSwitch();
+}
+
+/**
+ * Enters low power mode until the next interrupt occurs by delegating to the launchpad.
+ */
+void port_idle(void) {
+    launchpad_idle();
+}
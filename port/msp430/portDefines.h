@@ -0,0 +1,25 @@
+/**
+ * portDefines.h
+ *
+ * This Headerfile defines the MSP430 specific constants and macros required by port.h. All of them are derived from "launchpad.h".
+ *
+ */
+
+#ifndef PORT_MSP430_PORTDEFINES_H_
+#define PORT_MSP430_PORTDEFINES_H_
+
+#include "../../drivers/launchpad.h"
+
+#define PORT_STACK_ARENA            ((uint8_t*)gPortStackArena)                             //Defines the memory from which the stacks of the threads are carved
+#define PORT_STACK_ARENA_SIZE       STACK_ARENA_SIZE                                        //Defines the size of the stack arena in bytes
+#define PORT_STACK_ALIGNMENT        2                                                       //Defines the alignment of every stack in bytes, the stack pointer has to be word aligned
+#define PORT_TIMER_INTERVAL         LAUNCHPAD_TIMER_INTERVAL                                //Defines the duration of a time slice in system ticks
+#define PORT_TIMER_MAX_INTERVAL     LAUNCHPAD_TIMER_MAX_INTERVAL                            //Defines the maximum number of system ticks between two timer interrupts
+#define PORT_TIMESTAMP_FREQUENCY    LAUNCHPAD_TIMESTAMP_FREQUENCY                           //Defines the frequency of the timestamps in Hz
+#define PORT_CYCLE_FREQUENCY        LAUNCHPAD_CYCLE_FREQUENCY                               //Defines the frequency of the cycle counter in Hz
+
+typedef uint16_t PortCycles_t;                                                              //Defines the range of the cycle counter, which is the 16 bit register of TimerA1
+
+extern uint16_t gPortStackArena[STACK_ARENA_SIZE / 2];                                      //Memory, which is divided into the stacks of the threads. Declared as words for the alignment
+
+#endif /* PORT_MSP430_PORTDEFINES_H_ */
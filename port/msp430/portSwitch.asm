@@ -0,0 +1,28 @@
+;
+; portSwitch.asm
+;
+; This file implements the context switch of port.h for the MSP430X. Only the registers that have to be preserved across
+; a function call (R4 - R10) are saved, because the compiler already saved every other register before calling port_switchContext.
+; The saved context is the stack pointer after pushing these registers.
+;
+
+            .def    port_switchContext
+
+            .text
+
+;
+; void port_switchContext(PortContext_t* from, PortContext_t to)
+; R12 contains the address to store the current stack pointer to, R13 contains the stack pointer of the next thread.
+;
+port_switchContext:
+            PUSHM.A #7, R10                     ; Save R4 - R10 with 20 bit on the stack of the current thread
+            MOVX.A  SP, 0(R12)                  ; Save the stack pointer of the current thread
+            MOVA    R13, SP                     ; Continue on the stack of the next thread
+            POPM.A  #7, R10                     ; Restore R4 - R10 of the next thread
+        .if $DEFINED(__LARGE_CODE_MODEL__)
+            RETA                                ; Return to the next thread
+        .else
+            RET
+        .endif
+
+            .end
@@ -0,0 +1,96 @@
+/**
+ * port.h
+ *
+ * This Headerfile defines the processor specific functionality the scheduler and semaphor depend on. Every supported platform has its own
+ * implementation of these functions in a subdirectory of "port". The platform specific "portDefines.h" additionally has to define
+ * ATOMIC_START/ATOMIC_END, THREADPOOL_SIZE, PORT_STACK_ARENA, PORT_STACK_ARENA_SIZE, PORT_STACK_ALIGNMENT, PORT_TIMER_INTERVAL, PORT_TIMER_MAX_INTERVAL,
+ * PORT_TIMESTAMP_FREQUENCY, PORT_CYCLE_FREQUENCY and the type PortCycles_t.
+ *
+ */
+
+#ifndef PORT_H_
+#define PORT_H_
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#if defined(__MSP430__) || defined(LAUNCHPAD_SIMULATOR)                        //The simulated launchpad uses the configuration of the launchpad
+#include "msp430/portDefines.h"
+#else
+#include "linux/portDefines.h"
+#endif
+
+typedef void* PortContext_t;                    //Defines the saved context of a thread, which is the stack pointer after all callee-saved registers have been pushed
+
+typedef void (*PortEntry_t)(void);              //Defines the function a new context starts with. This function must never return
+
+/**
+ * Prepares the stack of a new thread, which starts at stackBase and has a size of stackSize bytes, so the first switch to the returned context
+ * starts executing the entry function.
+ */
+void port_initContext(PortContext_t* context, uint8_t* stackBase, size_t stackSize, PortEntry_t entry);
+
+/**
+ * Saves the callee-saved registers of the running thread into from and continues with the thread saved in to.
+ * This returns when a different thread switches back to from. It has to be called with global interrupts disabled.
+ */
+void port_switchContext(PortContext_t* from, PortContext_t to);
+
+/**
+ * Enables global interrupts. This is used by new threads, because they are always started with global interrupts disabled.
+ */
+void port_enableInterrupts(void);
+
+/**
+ * Returns the current system ticks, which are approx. milliseconds.
+ */
+uint32_t port_getSystemTicks(void);
+
+/**
+ * Returns a timestamp with a resolution of PORT_TIMESTAMP_FREQUENCY, which is much higher than the one of the system ticks. Only differences of timestamps are meaningful.
+ */
+uint32_t port_getTimestamp(void);
+
+/**
+ * Returns a timestamp with PORT_TIMESTAMP_FREQUENCY as cheap as the port allows, which is meant for trace points. The lower 16 bit are exact,
+ * but the upper 16 bit may lag behind by one wrap of the lower ones. So a sequence of raw timestamps is only monotonic after adding 65536 where it runs backwards.
+ * This has to be called with global interrupts disabled.
+ */
+uint32_t port_getRawTimestamp(void);
+
+/**
+ * Returns the count of a free running counter with PORT_CYCLE_FREQUENCY, which resolves the duration of a few instructions. The counter wraps
+ * within the range of PortCycles_t, so only differences cast to PortCycles_t of durations shorter than a wrap are meaningful. It may stop while the CPU is idle.
+ */
+PortCycles_t port_getCycles(void);
+
+/**
+ * Requests the execution of the timerCallback at the specified absolute system tick. Deadlines further away than PORT_TIMER_MAX_INTERVAL are capped.
+ */
+void port_setTimerDeadline(uint32_t deadline);
+
+/**
+ * Requests a deferred switch. The port executes the switchCallback as soon as global interrupts are enabled again, which is after the exit
+ * of the current interrupt or at the end of the current atomic section, so a switch never happens in the middle of an interrupt.
+ * Several requests before that result in a single execution.
+ */
+void port_requestSwitch(void);
+
+/**
+ * Waits with global interrupts enabled until the next interrupt occurs, which may make a thread ready. Global interrupts are disabled again afterwards.
+ * This has to be called with global interrupts disabled.
+ */
+void port_idle(void);
+
+/**
+ * The timer callback is to be implemented by the OS and is called by the port every time the requested deadline has been reached.
+ * The parameter contains the system ticks passed since the last execution. It is informational only, the scheduler ignores it and uses port_getSystemTicks.
+ */
+void timerCallback(uint16_t time);
+
+/**
+ * The switch callback is to be implemented by the OS and is called by the port for the requests of port_requestSwitch. It may switch to a different thread.
+ */
+void switchCallback(void);
+
+#endif /* PORT_H_ */
@@ -0,0 +1,140 @@
+/**
+ * port.c
+ *
+ * This file implements port.h for the simulated launchpad on Linux. The configuration is the one of the launchpad, so the scheduler is built
+ * exactly like on the MSP430. Threads are switched with ucontext, but run on stacks of the host, because the C library requires a lot more
+ * stack than the MSP430. The stacks carved from the stack arena are therefore only used to identify a thread and their usage is always 0.
+ * The timer related functionality is delegated to the simulated launchpad.
+ *
+ */
+
+#if defined(LAUNCHPAD_SIMULATOR)
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+#include "../port.h"
+
+#define PORT_HOST_STACK_SIZE        65536                               //Size of the stack of the host that replaces a stack of the arena
+
+typedef struct HostStack {                                              //Stack of the host, which belongs to a stack of the arena
+    uint8_t* stackBase;
+    uint8_t* memory;
+    struct HostStack* next;
+} HostStack_t;
+
+uint16_t gPortStackArena[STACK_ARENA_SIZE / 2];                         //Memory, which is divided into the stacks of the threads
+
+static ucontext_t gMainContext;                                         //Context of the main thread, which does not run on a stack of the arena
+static HostStack_t* gHostStacks = NULL;                                 //Stacks of the host allocated so far
+
+/**
+ * Returns the stack of the host, which belongs to the stack of the arena. A stack of the arena keeps its stack of the host when its slot is reused.
+ */
+static uint8_t* port_getHostStack(uint8_t* stackBase);
+
+/**
+ * Places the ucontext_t of the new thread at the upper end of its stack of the host and uses the remaining stack for the thread itself.
+ */
+void port_initContext(PortContext_t* context, uint8_t* stackBase, size_t stackSize, PortEntry_t entry) {
+    uint8_t* memory = port_getHostStack(stackBase);
+    ucontext_t* uc = (ucontext_t*)(((uintptr_t)(memory + PORT_HOST_STACK_SIZE) - sizeof(ucontext_t)) & ~(uintptr_t)15);
+
+    (void)stackSize;
+    getcontext(uc);
+    uc->uc_stack.ss_sp = memory;
+    uc->uc_stack.ss_size = (uint8_t*)uc - memory;
+    uc->uc_link = NULL;
+    makecontext(uc, entry, 0);
+    *context = uc;
+}
+
+/**
+ * Saves the running thread into from and continues with the thread saved in to. The main thread has no context of its own until its first switch.
+ */
+void port_switchContext(PortContext_t* from, PortContext_t to) {
+    if(*from == NULL) {
+        *from = &gMainContext;
+    }
+    swapcontext((ucontext_t*)*from, (ucontext_t*)to);
+}
+
+/**
+ * Enables the simulated global interrupts.
+ */
+void port_enableInterrupts(void) {
+    __enable_interrupt();
+}
+
+/**
+ * Returns the current system ticks by delegating to the launchpad.
+ */
+uint32_t port_getSystemTicks(void) {
+    return launchpad_getSystemTicks();
+}
+
+/**
+ * Returns a timestamp in counts of TimerA0 by delegating to the launchpad.
+ */
+uint32_t port_getTimestamp(void) {
+    return launchpad_getTimestamp();
+}
+
+/**
+ * Returns the virtual time in counts of TimerA0 by delegating to the launchpad.
+ */
+uint32_t port_getRawTimestamp(void) {
+    return launchpad_getRawTimestamp();
+}
+
+/**
+ * Returns the cycle counter by delegating to the launchpad.
+ */
+PortCycles_t port_getCycles(void) {
+    return launchpad_getCycleCount();
+}
+
+/**
+ * Requests the execution of the timerCallback at the specified absolute system tick by delegating to the launchpad.
+ */
+void port_setTimerDeadline(uint32_t deadline) {
+    launchpad_setTimerDeadline(deadline);
+}
+
+/**
+ * Requests a deferred switch by delegating to the launchpad.
+ */
+void port_requestSwitch(void) {
+    launchpad_requestSwitch();
+}
+
+/**
+ * Advances the virtual time until the next interrupt by delegating to the launchpad.
+ */
+void port_idle(void) {
+    launchpad_idle();
+}
+
+/**
+ * Returns the stack of the host, which belongs to the stack of the arena, and allocates it on first use.
+ */
+static uint8_t* port_getHostStack(uint8_t* stackBase) {
+    HostStack_t* stack = gHostStacks;
+    while(stack != NULL && stack->stackBase != stackBase) {
+        stack = stack->next;
+    }
+    if(stack == NULL) {
+        stack = malloc(sizeof(HostStack_t));
+        if(stack == NULL || (stack->memory = malloc(PORT_HOST_STACK_SIZE)) == NULL) {
+            fprintf(stderr, "out of memory for the stack of a thread\n");
+            exit(1);
+        }
+        stack->stackBase = stackBase;
+        stack->next = gHostStacks;
+        gHostStacks = stack;
+    }
+    return stack->memory;
+}
+
+#endif /* LAUNCHPAD_SIMULATOR */
@@ -0,0 +1,240 @@
+/**
+ * sampleLog.c
+ *
+ * This file contains the implementation of the functionality declared in sampleLog.h.
+ *
+ * Every block starts with a header of a marker, a sequence number and the number of bytes used. A sample is stored as the difference of its
+ * timestamp and the zigzag encoded difference of its value, both as LEB128 varints. The first sample of a block is stored relative to 0,
+ * so every block can be decoded on its own. Samples taken at a regular interval with small changes take 2 instead of 6 bytes.
+ *
+ */
+
+#include <string.h>
+#include "sampleLog.h"
+#include "port/port.h"
+
+#define SAMPLELOG_DATA_SIZE         (SAMPLELOG_BLOCK_SIZE - 3 * sizeof(uint16_t))   //Defines the number of bytes for samples in a block
+#define SAMPLELOG_RECORD_MAX        8                                               //Defines the maximum size of an encoded sample, 5 bytes for the time and 3 for the value
+
+typedef struct {                                                                    //Defines a block of the log
+    uint16_t magic;                                                                 //SAMPLELOG_BLOCK_MAGIC if the block contains samples
+    uint16_t sequence;                                                              //Incremented for every new block, the head has the highest one
+    uint16_t used;                                                                  //Bytes used by samples. Written after the samples, so it marks the last complete one
+    uint8_t data[SAMPLELOG_DATA_SIZE];
+} SampleLogBlock_t;
+
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_SECTION(gSampleLog, ".samplelog")                                      //Place the log in the FRAMLOG memory, which is not initialized at startup
+#endif
+static SampleLogBlock_t gSampleLog[SAMPLELOG_BLOCKS];                               //Defines the ring of blocks in FRAM
+static uint16_t gHeadBlock = 0;                                                     //Index of the block that samples are appended to
+static SampleLogEntry_t gLastEntry;                                                 //Last sample appended, which is the base of the next difference
+
+/**
+ * Checks if a block contains samples.
+ */
+static int sampleLog_isValid(uint16_t block);
+
+/**
+ * Starts a new empty block with the specified sequence number.
+ */
+static void sampleLog_startBlock(uint16_t block, uint16_t sequence);
+
+/**
+ * Encodes a sample relative to the last sample appended and returns its size.
+ */
+static uint16_t sampleLog_encode(uint8_t* record, uint32_t timestamp, uint16_t value);
+
+/**
+ * Decodes the sample at the specified offset by adding its differences to the previous sample and returns the offset of the next sample.
+ */
+static uint16_t sampleLog_decode(const uint8_t* data, uint16_t offset, SampleLogEntry_t* previous);
+
+/**
+ * Recovers the head of the log. Sequence numbers are compared by their difference, because the valid blocks always
+ * lie within a window of SAMPLELOG_BLOCKS consecutive sequence numbers, even after an overflow. The last sample of the head block is decoded,
+ * so the next sample continues its differences.
+ */
+void sampleLog_init(void) {
+    uint16_t i;
+    int found = 0;
+    for(i = 0; i < SAMPLELOG_BLOCKS; i++) {
+        if(sampleLog_isValid(i) && (!found || (int16_t)(gSampleLog[i].sequence - gSampleLog[gHeadBlock].sequence) > 0)) {
+            gHeadBlock = i;
+            found = 1;
+        }
+    }
+    if(!found) {
+        sampleLog_clear();
+        return;
+    }
+
+    uint16_t offset = 0;
+    gLastEntry.timestamp = 0;
+    gLastEntry.value = 0;
+    while(offset < gSampleLog[gHeadBlock].used) {
+        offset = sampleLog_decode(gSampleLog[gHeadBlock].data, offset, &gLastEntry);
+    }
+}
+
+/**
+ * Removes all samples by invalidating every block and starting over with the first one. This is an atomic function.
+ */
+void sampleLog_clear(void) {
+    unsigned short s;
+    uint16_t i;
+    ATOMIC_START(s);
+    for(i = 0; i < SAMPLELOG_BLOCKS; i++) {
+        gSampleLog[i].magic = 0;
+    }
+    sampleLog_startBlock(0, 0);
+    ATOMIC_END(s);
+}
+
+/**
+ * Appends a sample to the head block. If it does not fit anymore, the next block of the ring is started, which overwrites the oldest samples.
+ * The sample is only part of the log once the number of bytes used has been updated with a single write. This is an atomic function.
+ */
+void sampleLog_append(uint32_t timestamp, uint16_t value) {
+    unsigned short s;
+    uint8_t record[SAMPLELOG_RECORD_MAX];
+    ATOMIC_START(s);
+    SampleLogBlock_t* block = &gSampleLog[gHeadBlock];
+    uint16_t length = sampleLog_encode(record, timestamp, value);
+    if(block->used + length > SAMPLELOG_DATA_SIZE) {
+        sampleLog_startBlock(gHeadBlock + 1 == SAMPLELOG_BLOCKS ? 0 : gHeadBlock + 1, block->sequence + 1);
+        block = &gSampleLog[gHeadBlock];
+        length = sampleLog_encode(record, timestamp, value);
+    }
+    memcpy(&block->data[block->used], record, length);
+    block->used += length;
+    gLastEntry.timestamp = timestamp;
+    gLastEntry.value = value;
+    ATOMIC_END(s);
+}
+
+/**
+ * Positions a reader at the start of the oldest block, which is the first valid block after the head in the ring. This is an atomic function.
+ */
+void sampleLog_openReader(SampleLogReader_t* reader) {
+    unsigned short s;
+    ATOMIC_START(s);
+    uint16_t block = gHeadBlock;
+    do {
+        block = block + 1 == SAMPLELOG_BLOCKS ? 0 : block + 1;
+    } while(!sampleLog_isValid(block));
+    reader->block = block;
+    reader->sequence = gSampleLog[block].sequence;
+    reader->offset = 0;
+    reader->previous.timestamp = 0;
+    reader->previous.value = 0;
+    ATOMIC_END(s);
+}
+
+/**
+ * Reads the next sample and moves on to the next block at the end of a block. Reading stops at the end of the head block, but continues
+ * with samples appended later. If the block of the reader has been overwritten, the reader starts over at the oldest block.
+ * This is an atomic function, which decodes only one sample at a time.
+ */
+int sampleLog_read(SampleLogReader_t* reader, SampleLogEntry_t* entry) {
+    unsigned short s;
+    int err = 0;
+    ATOMIC_START(s);
+    while(1) {
+        SampleLogBlock_t* block = &gSampleLog[reader->block];
+        if(!sampleLog_isValid(reader->block) || block->sequence != reader->sequence) {
+            sampleLog_openReader(reader);
+        } else if(reader->offset < block->used) {
+            reader->offset = sampleLog_decode(block->data, reader->offset, &reader->previous);
+            *entry = reader->previous;
+            break;
+        } else if(reader->block == gHeadBlock) {
+            err = -1;
+            break;
+        } else {
+            reader->block = reader->block + 1 == SAMPLELOG_BLOCKS ? 0 : reader->block + 1;
+            reader->sequence = gSampleLog[reader->block].sequence;
+            reader->offset = 0;
+            reader->previous.timestamp = 0;
+            reader->previous.value = 0;
+        }
+    }
+    ATOMIC_END(s);
+    return err;
+}
+
+/**
+ * Reads up to count samples in one pass and returns the number of samples read.
+ */
+uint16_t sampleLog_readEntries(SampleLogReader_t* reader, SampleLogEntry_t* entries, uint16_t count) {
+    uint16_t i = 0;
+    while(i < count && sampleLog_read(reader, &entries[i]) == 0) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * Checks if a block contains samples by its marker and a plausible number of bytes used.
+ */
+static int sampleLog_isValid(uint16_t block) {
+    return gSampleLog[block].magic == SAMPLELOG_BLOCK_MAGIC && gSampleLog[block].used <= SAMPLELOG_DATA_SIZE;
+}
+
+/**
+ * Starts a new empty block. The marker is removed first and only written again after the header is complete,
+ * so a reset in between leaves an invalid block instead of a block with old samples and a new sequence number.
+ */
+static void sampleLog_startBlock(uint16_t block, uint16_t sequence) {
+    gSampleLog[block].magic = 0;
+    gSampleLog[block].used = 0;
+    gSampleLog[block].sequence = sequence;
+    gSampleLog[block].magic = SAMPLELOG_BLOCK_MAGIC;
+    gHeadBlock = block;
+    gLastEntry.timestamp = 0;
+    gLastEntry.value = 0;
+}
+
+/**
+ * Encodes the differences of a sample to the last sample appended. The difference of the value is zigzag encoded, so small negative
+ * differences also take only a few bits. Both differences are stored with 7 bits per byte, the highest bit marks a following byte.
+ */
+static uint16_t sampleLog_encode(uint8_t* record, uint32_t timestamp, uint16_t value) {
+    int32_t valueDelta = (int32_t)value - gLastEntry.value;
+    uint32_t fields[2];
+    uint16_t length = 0;
+    uint8_t i;
+
+    fields[0] = timestamp - gLastEntry.timestamp;
+    fields[1] = ((uint32_t)valueDelta << 1) ^ (uint32_t)(valueDelta >> 31);
+    for(i = 0; i < 2; i++) {
+        while(fields[i] >= 0x80) {
+            record[length++] = (uint8_t)fields[i] | 0x80;
+            fields[i] >>= 7;
+        }
+        record[length++] = (uint8_t)fields[i];
+    }
+    return length;
+}
+
+/**
+ * Decodes both varints of a sample and adds the differences to the previous sample.
+ */
+static uint16_t sampleLog_decode(const uint8_t* data, uint16_t offset, SampleLogEntry_t* previous) {
+    uint32_t fields[2];
+    uint8_t i;
+
+    for(i = 0; i < 2; i++) {
+        uint8_t shift = 0;
+        uint8_t byte;
+        fields[i] = 0;
+        do {
+            byte = data[offset++];
+            fields[i] |= (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while(byte & 0x80);
+    }
+    previous->timestamp += fields[0];
+    previous->value += (uint16_t)((fields[1] >> 1) ^ (0 - (fields[1] & 1)));
+    return offset;
+}
@@ -0,0 +1,62 @@
+/**
+ * sampleLog.h
+ *
+ * This Headerfile defines the structure and functions of a persistent log of samples in FRAM. Samples are stored as differences to the previous
+ * sample with a variable length encoding in a ring of blocks, so the oldest block is overwritten when the log is full. After a reset the head of the
+ * log is recovered from the block headers.
+ *
+ */
+
+
+#ifndef SAMPLELOG_H_
+#define SAMPLELOG_H_
+
+#include <inttypes.h>
+
+#define SAMPLELOG_BLOCK_SIZE        256                                 //Defines the size of a block in bytes, including its header
+#define SAMPLELOG_BLOCKS            128                                 //Defines the number of blocks. The log has to match the FRAMLOG memory of the linker command file
+#define SAMPLELOG_BLOCK_MAGIC       0x5A4C                              //Defines the marker of a block which contains samples
+
+typedef struct {                                                        //Defines a sample of the log
+    uint32_t timestamp;                                                 //System ticks at which the sample has been taken
+    uint16_t value;
+} SampleLogEntry_t;
+
+typedef struct {                                                        //Defines the position of a reader in the log
+    uint16_t block;
+    uint16_t sequence;                                                  //Sequence number of the block, which tells if the block has been overwritten
+    uint16_t offset;
+    SampleLogEntry_t previous;                                          //Last sample read, which is the base of the next difference
+} SampleLogReader_t;
+
+/**
+ * Recovers the head of the log after a reset. An empty or damaged log is cleared.
+ */
+void sampleLog_init(void);
+
+/**
+ * Removes all samples from the log.
+ */
+void sampleLog_clear(void);
+
+/**
+ * Appends a sample to the log. The oldest block is overwritten when the log is full.
+ */
+void sampleLog_append(uint32_t timestamp, uint16_t value);
+
+/**
+ * Positions a reader at the oldest sample of the log.
+ */
+void sampleLog_openReader(SampleLogReader_t* reader);
+
+/**
+ * Reads the next sample. Returns -1 if there is no further sample yet. Samples overwritten while reading are skipped.
+ */
+int sampleLog_read(SampleLogReader_t* reader, SampleLogEntry_t* entry);
+
+/**
+ * Reads up to count samples in one pass and returns the number of samples read.
+ */
+uint16_t sampleLog_readEntries(SampleLogReader_t* reader, SampleLogEntry_t* entries, uint16_t count);
+
+#endif /* SAMPLELOG_H_ */
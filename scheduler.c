@@ -1,77 +1,239 @@
 /**
  * scheduler.c
  *
- * This file implements the functionality of scheduler.h. This requires a "launchpad.h" file to be present which should contain
- * the various hardware related parameters.
+ * This file implements the functionality of scheduler.h. This requires a port of "port.h" to be present which should contain
+ * the various hardware related parameters and functions.
  *
  */
 
 #include "scheduler.h"
-#include "drivers/launchpad.h"
+#include "port/port.h"
+#include "trace.h"
+#include "mutex.h"
+#include <string.h>
+
+#define STACK_FILL_PATTERN          0xA5                            //Every stack is filled with this pattern, so the peak usage can be measured
+
+typedef struct StackBlock {                                         //Defines the header of a free block of the stack arena, which is stored in the block itself
+    struct StackBlock* next;                                        //Links the block to the next free block at a higher address
+    size_t size;
+} StackBlock_t;
 
 static Thread_t gThreads[THREADPOOL_SIZE];                          //The current threadpool that contains all active threads. THREADPOOL_SIZE is a hardware related parameter
 static ThreadID_t gRunningThread = 0;                               //The currently running ThreadID_t
+static ThreadID_t gFreeSlots = THREAD_ID_INVALID;                   //Head of the list of unused slots in the threadpool
+static uint8_t gReadyBitmap = 0;                                    //Contains one bit for each priority level that has at least one ready thread
+static ThreadQueue_t gReadyQueues[THREAD_PRIORITY_LEVELS];          //Ready threads of every priority level. The first one is the next one to run
+static ThreadID_t gSleepingThreads = THREAD_ID_INVALID;             //Head of the sleep queue, which is sorted by wake-up time
+static unsigned char gIdling = 0;                                   //Set while the running thread waits in low power mode for a ready thread
+static uint32_t gSliceEnd = 0;                                      //System tick at which the time slice of the running thread ends
+static uint32_t gTimerDeadline = 0;                                 //System tick of the timer interrupt requested last
+#if THREAD_STATISTICS
+static uint32_t gLastSwitchTime = 0;                                //Timestamp since which the run time of the running thread has not been accounted yet
+#endif
+static size_t gStackArenaUsed = 0;                                  //Number of bytes at the start of the stack arena that have been carved into stacks
+static StackBlock_t* gFreeStacks = NULL;                            //Free blocks below gStackArenaUsed, sorted by their address
+
+//Lookup table for the index of the highest set bit of a nibble. Used to find the highest ready priority level in constant time.
+static const uint8_t gHighestBitTable[16] = {0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3};
+
+/**
+ * Takes a free thread slot from the list of free slots, preferably one with a stack of at least stackSize bytes.
+ * Returns an index or THREAD_ID_INVALID if the threadpool is full.
+ */
+static ThreadID_t scheduler_getNextOpenSlot(size_t stackSize);
+
+/**
+ * Assigns a stack of stackSize bytes to a thread slot and fills it with the STACK_FILL_PATTERN. Returns 0 on success.
+ */
+static int scheduler_assignStack(ThreadID_t id, size_t stackSize);
 
 /**
- * Searches for a free thread slot by checking if the status is invalid. Returns an index.
+ * Takes a block of at least *stackSize bytes from the free blocks or the unused end of the stack arena and writes its actual size.
+ * Returns NULL if there is no large enough block.
  */
-static ThreadID_t scheduler_getNextOpenSlot(void);
+static uint8_t* scheduler_allocateStack(size_t* stackSize);
 
 /**
- * Searches for the next ready thread to be continued with the round robin principle.
+ * Returns a stack to the stack arena and merges it with the adjacent free blocks.
+ */
+static void scheduler_releaseStack(uint8_t* stack, size_t stackSize);
+
+/**
+ * Searches for the next ready thread to be continued. This is the first thread of the highest ready priority level.
  */
 static ThreadID_t scheduler_getPendingThread(void);
 
+/**
+ * Returns the highest priority level with a ready thread. The ready bitmap must not be empty.
+ */
+static ThreadPriority_t scheduler_getHighestReadyPriority(void);
+
+/**
+ * Requests a deferred switch, if a ready thread has a higher priority than the running thread.
+ */
+static void scheduler_checkPreemption(void);
+
+/**
+ * Starts the time slice of the thread that has just been switched to.
+ */
+static void scheduler_startTimeSlice(ThreadID_t id);
+
+/**
+ * Appends a ready thread to the ready queue of its priority level.
+ */
+static void scheduler_enqueueReadyThread(ThreadID_t id);
+
+/**
+ * Removes and returns the first thread from the ready queue of the specified priority level.
+ */
+static ThreadID_t scheduler_dequeueReadyThread(ThreadPriority_t priority);
+
+/**
+ * Adds a thread to a queue according to the order of the queue.
+ */
+static void scheduler_enqueue(ThreadQueue_t* queue, ThreadID_t id);
+
+/**
+ * Removes and returns the first thread of a queue. Returns THREAD_ID_INVALID if the queue is empty.
+ */
+static ThreadID_t scheduler_dequeue(ThreadQueue_t* queue);
+
+/**
+ * Removes a thread from anywhere in a queue. Returns 0 if the thread was found in the queue.
+ */
+static int scheduler_removeFromQueue(ThreadQueue_t* queue, ThreadID_t id);
+
+/**
+ * Inserts the running thread into the sleep queue according to its wake-up time.
+ */
+static void scheduler_insertSleepingThread(ThreadID_t id);
+
+/**
+ * Removes a thread from anywhere in the sleep queue.
+ */
+static void scheduler_removeSleepingThread(ThreadID_t id);
+
+/**
+ * Requests the next timer interrupt for the earliest wake-up time or the end of the time slice.
+ */
+static void scheduler_programTimer(void);
+
+/**
+ * Entry function of every new thread. Executes the function of the thread and releases its resources afterwards.
+ */
+static void scheduler_threadEntry(void);
+
 /**
  * Invalidates the status of the current thread to release its resources.
  */
 static void scheduler_killThread(void);
 
+#if THREAD_STATISTICS
 /**
- * Implementation of the function that is being executed every "system tick" by the timer module.
+ * Adds the time since the last switch to the run time of a thread, unless the CPU was idling.
  */
-void timerCallback(uint16_t time);
+static void scheduler_accountRunTime(ThreadID_t id);
+
+/**
+ * Records the wake-up latency of a thread that is running again after it has been resumed.
+ */
+static void scheduler_accountWakeup(ThreadID_t id);
+#else
+#define scheduler_accountRunTime(id)
+#define scheduler_accountWakeup(id)
+#endif
 
 /**
  * Initializes the scheduler by invalidating every slot of the threadpool except the currently running one,
- * which is the main thread.
+ * which is the main thread. All invalidated slots are linked into the list of free slots and every ready queue is emptied.
  */
 void scheduler_init(void) {
     unsigned int i;
-    for(i = 0; i < THREADPOOL_SIZE; i++) {
-        gThreads[i].state = THREADSTATE_INVALID;
+    gFreeSlots = THREAD_ID_INVALID;
+    for(i = THREADPOOL_SIZE; i > 0; i--) {
+        gThreads[i - 1].state = THREADSTATE_INVALID;
+        gThreads[i - 1].stack = NULL;
+        gThreads[i - 1].stackSize = 0;
+        if(i - 1 != gRunningThread) {
+            gThreads[i - 1].next = gFreeSlots;
+            gFreeSlots = i - 1;
+        }
     }
+    for(i = 0; i < THREAD_PRIORITY_LEVELS; i++) {
+        scheduler_initQueue(&gReadyQueues[i], THREADQUEUE_FIFO);
+    }
+    gReadyBitmap = 0;
+    gSleepingThreads = THREAD_ID_INVALID;
+    gStackArenaUsed = 0;
+    gFreeStacks = NULL;
+#if THREAD_STATISTICS
+    memset(&gThreads[gRunningThread].statistics, 0, sizeof(ThreadStatistics_t));
+    gThreads[gRunningThread].resumed = 0;
+    gLastSwitchTime = port_getTimestamp();
+#endif
     gThreads[gRunningThread].state = THREADSTATE_RUNNING;
+    gThreads[gRunningThread].priority = THREAD_PRIORITY_NORMAL;
+    gThreads[gRunningThread].timeSlice = PORT_TIMER_INTERVAL;
+    gThreads[gRunningThread].waitQueue = NULL;
+    gSliceEnd = port_getSystemTicks() + PORT_TIMER_INTERVAL;
+#if TRACE_ENABLED
+    trace_init();
+#endif
 }
 
 /**
  * Starts a new thread, if possible and returns the assigned id. This function takes a function pointer as a parameter,
- * which is being executed by the thread. This is an atomic function, that cannot be interrupted. A new thread is being initialized
- * and assigned an index in the threadpool. Each new thread receives its own share of the stack, which is being defined in "launchpad.h".
- * If it is possible to start a new thread its function is executed and after it finished, the resources are being released.
+ * which is being executed by the thread, the priority of the thread and the size of its stack. Priorities above THREAD_PRIORITY_HIGHEST are capped.
+ * This is an atomic function, that cannot be interrupted. A new thread is being initialized and assigned an index in the threadpool.
+ * Each new thread receives its own share of the stack arena, which is being defined by the port. The stack is prepared by the port,
+ * so the thread starts in scheduler_threadEntry the first time it is switched to. A new thread of a higher priority preempts the calling thread
+ * as soon as global interrupts are enabled again.
  */
-ThreadID_t scheduler_startThread(ThreadFunction_t function) {
+ThreadID_t scheduler_startThread(ThreadFunction_t function, ThreadPriority_t priority, size_t stackSize) {
     unsigned short s;
     ATOMIC_START(s);
     ThreadID_t newThread = THREAD_ID_INVALID;
-    newThread = scheduler_getNextOpenSlot();
+    stackSize = (stackSize + PORT_STACK_ALIGNMENT - 1) & ~(size_t)(PORT_STACK_ALIGNMENT - 1);
+    newThread = scheduler_getNextOpenSlot(stackSize);
     if(newThread == THREAD_ID_INVALID) {
+        ATOMIC_END(s);
         return newThread;
     }
+    if(scheduler_assignStack(newThread, stackSize) != 0) {
+        gThreads[newThread].next = gFreeSlots;                      //Return the slot, because there is not enough stack memory left
+        gFreeSlots = newThread;
+        ATOMIC_END(s);
+        return THREAD_ID_INVALID;
+    }
 
     gThreads[newThread].state = THREADSTATE_READY;
     gThreads[newThread].function = function;
+    gThreads[newThread].priority = priority > THREAD_PRIORITY_HIGHEST ? THREAD_PRIORITY_HIGHEST : priority;
+    gThreads[newThread].timeSlice = PORT_TIMER_INTERVAL;
+    gThreads[newThread].waitQueue = NULL;
+    mutex_initThread(newThread);
+#if THREAD_STATISTICS
+    memset(&gThreads[newThread].statistics, 0, sizeof(ThreadStatistics_t));
+    gThreads[newThread].resumed = 0;
+#endif
+    port_initContext(&gThreads[newThread].context, gThreads[newThread].stack, gThreads[newThread].stackSize, &scheduler_threadEntry);
+    scheduler_enqueueReadyThread(newThread);
+    TRACE(TRACE_EVENT_READY, newThread, 0);
+    scheduler_checkPreemption();
 
-    if(setjmp(gThreads[newThread].context) == 0) {
-        ATOMIC_END(s);
-        return newThread;
-    } else {
-        _set_SP_register(STACK_UPPER_EDGE_ADDRESS - (gRunningThread * STACKSIZE_PER_THREAD));
-        ATOMIC_END(s);
-        gThreads[gRunningThread].function();
-        scheduler_killThread();
-        return THREAD_ID_INVALID;
-    }
+    ATOMIC_END(s);
+    return newThread;
+}
+
+/**
+ * Entry function of every new thread. A thread is always switched to with global interrupts disabled, possibly from within an interrupt,
+ * so they are enabled first. Afterwards the function of the thread is executed and after it finished, the resources are being released.
+ */
+static void scheduler_threadEntry(void) {
+    port_enableInterrupts();
+    gThreads[gRunningThread].function();
+    scheduler_killThread();
 }
 
 /**
@@ -82,83 +244,461 @@ ThreadID_t scheduler_getRunningThread(void) {
 }
 
 /**
- * Interrupts the execution of the currently running thread, saves its registers and switches to the next pending thread.
- * This uses the round robin principle. If there is no other pending thread, the current thread is not being switched.
- * This is an atomic function.
+ * Returns the current priority of a thread.
+ */
+ThreadPriority_t scheduler_getPriority(ThreadID_t id) {
+    return gThreads[id].priority;
+}
+
+/**
+ * Changes the priority of a thread. A ready thread has to be moved from the ready queue of its old priority to the one of its new priority,
+ * where it is appended like any other thread that becomes ready. If a ready thread now has a higher priority than the running thread,
+ * a switch is requested, which happens at the end of the atomic section of the caller. This is an atomic function.
+ */
+void scheduler_setPriority(ThreadID_t id, ThreadPriority_t priority) {
+    unsigned short s;
+    ATOMIC_START(s);
+    if(priority > THREAD_PRIORITY_HIGHEST) {
+        priority = THREAD_PRIORITY_HIGHEST;
+    }
+    if(gThreads[id].state == THREADSTATE_READY && gThreads[id].priority != priority) {
+        ThreadPriority_t oldPriority = gThreads[id].priority;
+        if(scheduler_removeFromQueue(&gReadyQueues[oldPriority], id) == 0) {
+            if(gReadyQueues[oldPriority].head == THREAD_ID_INVALID) {
+                gReadyBitmap &= ~(1 << oldPriority);
+            }
+            gThreads[id].priority = priority;
+            scheduler_enqueueReadyThread(id);
+        }
+    }
+    gThreads[id].priority = priority;
+    scheduler_checkPreemption();
+    ATOMIC_END(s);
+}
+
+/**
+ * Sets the time slice of a thread. It takes effect with the next time slice of the thread. This is an atomic function.
+ */
+void scheduler_setTimeSlice(ThreadID_t id, uint16_t timeSlice) {
+    unsigned short s;
+    ATOMIC_START(s);
+    gThreads[id].timeSlice = timeSlice > 0 ? timeSlice : 1;
+    ATOMIC_END(s);
+}
+
+/**
+ * Returns the peak stack usage of a thread. The stack grows downwards, so every byte from the lowest address upwards that still contains
+ * the STACK_FILL_PATTERN has never been used.
+ */
+size_t scheduler_getStackUsage(ThreadID_t id) {
+    size_t unused = 0;
+    if(id >= THREADPOOL_SIZE) {
+        return 0;
+    }
+    while(unused < gThreads[id].stackSize && gThreads[id].stack[unused] == STACK_FILL_PATTERN) {
+        unused++;
+    }
+    return gThreads[id].stackSize - unused;
+}
+
+/**
+ * Interrupts the execution of the currently running thread, saves its registers with the port and switches to the next pending thread.
+ * The thread with the highest priority is chosen and threads of the same priority are run according to the round robin principle.
+ * A still running thread is appended to the ready queue of its priority level. If there is no other pending thread,
+ * the current thread is not being switched. If the current thread is sleeping or blocked and no thread is ready, the CPU enters
+ * low power mode until an interrupt makes a thread ready. An interrupt of the low power mode that does not make a thread ready returns right away,
+ * because the interrupted idle loop continues anyway. This is an atomic function.
  */
 void scheduler_runNextThread(void) {
     unsigned short s;
     ATOMIC_START(s);
     ThreadID_t nextThread = scheduler_getPendingThread();
-    switch (gThreads[nextThread].state) {
-        case THREADSTATE_RUNNING:
-            break;
-        case THREADSTATE_READY:
-            if(nextThread == gRunningThread) {
-                break;
-            }
-            if (setjmp(gThreads[gRunningThread].context) == 0) {
-                if (gThreads[gRunningThread].state == THREADSTATE_RUNNING) {
-                    gThreads[gRunningThread].state = THREADSTATE_READY;
-                }
-                gRunningThread = nextThread;
-                gThreads[gRunningThread].state = THREADSTATE_RUNNING;
-                longjmp(gThreads[gRunningThread].context,1);
-            }
-            break;
-        default:
+    while(nextThread == gRunningThread && gThreads[gRunningThread].state != THREADSTATE_RUNNING && gThreads[gRunningThread].state != THREADSTATE_READY) {
+        if(gIdling) {                                               //Called from an interrupt of the idle loop, do not nest another one
             break;
+        }
+        scheduler_accountRunTime(gRunningThread);
+        gIdling = 1;
+        TRACE(TRACE_EVENT_IDLE, TRACE_THREAD_NONE, 0);
+        port_idle();
+        scheduler_accountRunTime(gRunningThread);                   //Restarts the accounting without adding the time in low power mode
+        gIdling = 0;
+        nextThread = scheduler_getPendingThread();
+    }
+    if(nextThread == gRunningThread) {
+        if(gThreads[gRunningThread].state == THREADSTATE_READY) {   //The current thread was resumed before it could be switched
+            gThreads[gRunningThread].state = THREADSTATE_RUNNING;
+            scheduler_accountRunTime(gRunningThread);
+            scheduler_accountWakeup(gRunningThread);
+            TRACE(TRACE_EVENT_SWITCH, gRunningThread, gRunningThread);
+            scheduler_startTimeSlice(gRunningThread);
+        }
+    } else {
+        ThreadID_t previousThread = gRunningThread;
+        scheduler_accountRunTime(previousThread);
+        if (gThreads[previousThread].state == THREADSTATE_RUNNING) {
+#if THREAD_STATISTICS
+            gThreads[previousThread].statistics.preemptions++;
+#endif
+            gThreads[previousThread].state = THREADSTATE_READY;
+            scheduler_enqueueReadyThread(previousThread);
+        }
+#if THREAD_STATISTICS
+        else {
+            gThreads[previousThread].statistics.voluntarySwitches++;
+        }
+#endif
+        scheduler_accountWakeup(nextThread);
+        gRunningThread = nextThread;
+        gThreads[gRunningThread].state = THREADSTATE_RUNNING;
+        gIdling = 0;                                                //The next thread is not idling, even if this is called from an interrupt of the idle loop
+        TRACE(TRACE_EVENT_SWITCH, nextThread, previousThread);
+        scheduler_startTimeSlice(gRunningThread);
+        port_switchContext(&gThreads[previousThread].context, gThreads[gRunningThread].context);
     }
     ATOMIC_END(s);
 }
 
 /**
- * Puts a thread to sleep by changing its state and sets the sleep time.
- * The current thread is being switched to a pending thread.
+ * Puts a thread to sleep by changing its state and inserting it into the sleep queue with its absolute wake-up time.
+ * The timer is reprogrammed if the thread has to be woken up earlier than requested so far.
+ * The current thread is being switched to a pending thread. This is an atomic function.
  */
 void scheduler_threadSleep(uint16_t sleepTime) {
-    gThreads[gRunningThread].sleepTime = sleepTime;
+    unsigned short s;
+    ATOMIC_START(s);
+    gThreads[gRunningThread].wakeTime = port_getSystemTicks() + sleepTime;
     gThreads[gRunningThread].state = THREADSTATE_SLEEPING;
+    TRACE(TRACE_EVENT_SLEEPING, gRunningThread, sleepTime);
+    scheduler_insertSleepingThread(gRunningThread);
+    if(gSleepingThreads == gRunningThread) {
+        scheduler_programTimer();
+    }
     scheduler_runNextThread();
+    ATOMIC_END(s);
+}
+
+/**
+ * Inserts a thread into the sleep queue behind every thread that wakes up earlier or at the same time.
+ * This is only linear in the number of sleeping threads and happens once per sleep, not on every system tick.
+ */
+static void scheduler_insertSleepingThread(ThreadID_t id) {
+    ThreadID_t* link = &gSleepingThreads;
+    while(*link != THREAD_ID_INVALID && (int32_t)(gThreads[*link].wakeTime - gThreads[id].wakeTime) <= 0) {
+        link = &gThreads[*link].sleepNext;
+    }
+    gThreads[id].sleepNext = *link;
+    *link = id;
+}
+
+/**
+ * Removes a thread from anywhere in the sleep queue. The timer is not reprogrammed, an early deadline only causes a timer interrupt without a wake-up.
+ */
+static void scheduler_removeSleepingThread(ThreadID_t id) {
+    ThreadID_t* link = &gSleepingThreads;
+    while(*link != THREAD_ID_INVALID && *link != id) {
+        link = &gThreads[*link].sleepNext;
+    }
+    if(*link != THREAD_ID_INVALID) {
+        *link = gThreads[id].sleepNext;
+    }
 }
 
 /**
- * Searches for a pending thread to be continued.
+ * Requests the next timer interrupt. If threads of the priority of the running thread are waiting to run, the timer has to interrupt
+ * at the end of the time slice. Threads of a lower priority cannot run anyway and threads of a higher priority have already preempted the running thread.
+ * Otherwise only the earliest wake-up time of the sleep queue matters and the port caps the deadline to its maximum interval.
+ */
+static void scheduler_programTimer(void) {
+    uint32_t now = port_getSystemTicks();
+    uint32_t deadline = now + PORT_TIMER_MAX_INTERVAL;
+
+    if((gReadyBitmap & (1 << gThreads[gRunningThread].priority)) && (int32_t)(gSliceEnd - deadline) < 0) {
+        deadline = gSliceEnd;
+    }
+
+    if(gSleepingThreads != THREAD_ID_INVALID && (int32_t)(gThreads[gSleepingThreads].wakeTime - deadline) < 0) {
+        deadline = gThreads[gSleepingThreads].wakeTime;
+    }
+    gTimerDeadline = deadline;
+    port_setTimerDeadline(deadline);
+}
+
+/**
+ * Searches for a pending thread to be continued. The highest ready priority level is resolved with the ready bitmap, so the cost
+ * does not depend on the number of threads. A running thread of a higher priority than every ready thread keeps running.
+ * The returned thread is removed from its ready queue.
  */
 static ThreadID_t scheduler_getPendingThread(void) {
-    unsigned int i = gRunningThread;
-    do {
-        i = (i + 1) % THREADPOOL_SIZE;
-        if(gThreads[i].state == THREADSTATE_READY) {
-            return i;
+    ThreadPriority_t priority;
+    if(gReadyBitmap == 0) {
+        return gRunningThread;
+    }
+
+    priority = scheduler_getHighestReadyPriority();
+    if(gThreads[gRunningThread].state == THREADSTATE_RUNNING && gThreads[gRunningThread].priority > priority) {
+        return gRunningThread;
+    }
+
+    return scheduler_dequeueReadyThread(priority);
+}
+
+/**
+ * Resolves the highest ready priority level with the lookup table, one nibble of the ready bitmap at a time.
+ */
+static ThreadPriority_t scheduler_getHighestReadyPriority(void) {
+    if(gReadyBitmap & 0xF0) {
+        return 4 + gHighestBitTable[gReadyBitmap >> 4];
+    }
+    return gHighestBitTable[gReadyBitmap];
+}
+
+/**
+ * Requests a deferred switch from the port, if the running thread is running and a ready thread has a higher priority. The port executes
+ * the switchCallback as soon as global interrupts are enabled, which is at the exit of the current interrupt or at the end of the current atomic section.
+ * While the CPU is idling, the interrupted idle loop switches anyway.
+ */
+static void scheduler_checkPreemption(void) {
+    if(gThreads[gRunningThread].state == THREADSTATE_RUNNING && gReadyBitmap != 0
+            && scheduler_getHighestReadyPriority() > gThreads[gRunningThread].priority) {
+        port_requestSwitch();
+    }
+}
+
+/**
+ * Starts the time slice of a thread. The timer only has to end it, if a thread of the same priority is waiting to run. The timer is only
+ * reprogrammed if the slice ends before the requested timer interrupt, otherwise that interrupt moves the deadline to the end of the slice.
+ * This keeps the cost of a switch low, because programming the timer is expensive on some ports.
+ */
+static void scheduler_startTimeSlice(ThreadID_t id) {
+    gSliceEnd = port_getSystemTicks() + gThreads[id].timeSlice;
+    if((gReadyBitmap & (1 << gThreads[id].priority)) && (int32_t)(gSliceEnd - gTimerDeadline) < 0) {
+        scheduler_programTimer();
+    }
+}
+
+/**
+ * Appends a ready thread to the ready queue of its priority level and marks the level in the ready bitmap.
+ */
+static void scheduler_enqueueReadyThread(ThreadID_t id) {
+    ThreadPriority_t priority = gThreads[id].priority;
+    scheduler_enqueue(&gReadyQueues[priority], id);
+    gReadyBitmap |= 1 << priority;
+}
+
+/**
+ * Removes and returns the first thread from the ready queue of the specified priority level. The level is cleared
+ * from the ready bitmap if its queue becomes empty. The queue must not be empty.
+ */
+static ThreadID_t scheduler_dequeueReadyThread(ThreadPriority_t priority) {
+    ThreadID_t id = scheduler_dequeue(&gReadyQueues[priority]);
+    if(gReadyQueues[priority].head == THREAD_ID_INVALID) {
+        gReadyBitmap &= ~(1 << priority);
+    }
+    return id;
+}
+
+/**
+ * Adds a thread to a queue. A FIFO queue appends the thread in constant time. A priority ordered queue inserts the thread behind
+ * every thread of the same or a higher priority, so threads of the same priority are still taken in FIFO order.
+ */
+static void scheduler_enqueue(ThreadQueue_t* queue, ThreadID_t id) {
+    ThreadID_t* link;
+
+    if(queue->order == THREADQUEUE_PRIORITY && queue->tail != THREAD_ID_INVALID && gThreads[queue->tail].priority < gThreads[id].priority) {
+        link = &queue->head;
+        while(gThreads[*link].priority >= gThreads[id].priority) {    //Terminates at the latest at the tail, which has a lower priority
+            link = &gThreads[*link].next;
         }
-    } while (i != gRunningThread);
+        gThreads[id].next = *link;
+        *link = id;
+        return;
+    }
 
-    return gRunningThread;
+    gThreads[id].next = THREAD_ID_INVALID;
+    if(queue->tail == THREAD_ID_INVALID) {
+        queue->head = id;
+    } else {
+        gThreads[queue->tail].next = id;
+    }
+    queue->tail = id;
+}
+
+/**
+ * Removes a thread from anywhere in a queue. This is linear in the number of threads in front of it. Returns 0 if the thread was found in the queue.
+ */
+static int scheduler_removeFromQueue(ThreadQueue_t* queue, ThreadID_t id) {
+    ThreadID_t* link = &queue->head;
+    ThreadID_t previous = THREAD_ID_INVALID;
+
+    while(*link != THREAD_ID_INVALID && *link != id) {
+        previous = *link;
+        link = &gThreads[*link].next;
+    }
+    if(*link == THREAD_ID_INVALID) {
+        return -1;
+    }
+
+    *link = gThreads[id].next;
+    if(queue->tail == id) {
+        queue->tail = previous;
+    }
+    return 0;
+}
+
+/**
+ * Removes and returns the first thread of a queue in constant time. Returns THREAD_ID_INVALID if the queue is empty.
+ */
+static ThreadID_t scheduler_dequeue(ThreadQueue_t* queue) {
+    ThreadID_t id = queue->head;
+    if(id != THREAD_ID_INVALID) {
+        queue->head = gThreads[id].next;
+        if(queue->head == THREAD_ID_INVALID) {
+            queue->tail = THREAD_ID_INVALID;
+        }
+    }
+    return id;
+}
+
+/**
+ * Takes an open slot for a new thread from the list of free slots. A slot keeps the stack of its terminated thread, so the first slot
+ * with a large enough stack is preferred. Otherwise the first free slot is taken.
+ */
+static ThreadID_t scheduler_getNextOpenSlot(size_t stackSize) {
+    ThreadID_t* link = &gFreeSlots;
+    ThreadID_t id;
+
+    while(*link != THREAD_ID_INVALID && gThreads[*link].stackSize < stackSize) {
+        link = &gThreads[*link].next;
+    }
+    if(*link == THREAD_ID_INVALID) {
+        link = &gFreeSlots;
+    }
+
+    id = *link;
+    if(id != THREAD_ID_INVALID) {
+        *link = gThreads[id].next;
+    }
+
+    return id;
 }
 
 /**
- * Searches for an open slot in the threadpool for a new thread.
+ * Assigns a stack to a thread slot. The stack of the slot is reused if it is large enough, otherwise it is returned to the stack arena
+ * and a new stack is allocated. If the arena has no large enough block, the stacks kept by the other free slots are returned as well,
+ * so the memory of terminated threads is never lost. The whole stack is filled with the STACK_FILL_PATTERN to be able to measure its peak usage.
  */
-static ThreadID_t scheduler_getNextOpenSlot() {
-    unsigned int i = 0;
+static int scheduler_assignStack(ThreadID_t id, size_t stackSize) {
+    size_t i;
 
-    for (i = 0; i < THREADPOOL_SIZE; i++) {
-        if(gThreads[i].state == THREADSTATE_INVALID) {
-            return i;
+    if(stackSize < sizeof(StackBlock_t)) {
+        stackSize = sizeof(StackBlock_t);                           //Every stack has to be able to hold the header of a free block
+    }
+    if(gThreads[id].stackSize < stackSize) {
+        ThreadID_t slot;
+        if(gThreads[id].stack != NULL) {
+            scheduler_releaseStack(gThreads[id].stack, gThreads[id].stackSize);
+            gThreads[id].stack = NULL;
+            gThreads[id].stackSize = 0;
         }
+        gThreads[id].stack = scheduler_allocateStack(&stackSize);
+        for(slot = gFreeSlots; gThreads[id].stack == NULL && slot != THREAD_ID_INVALID; slot = gThreads[slot].next) {
+            if(gThreads[slot].stack != NULL) {
+                scheduler_releaseStack(gThreads[slot].stack, gThreads[slot].stackSize);
+                gThreads[slot].stack = NULL;
+                gThreads[slot].stackSize = 0;
+                gThreads[id].stack = scheduler_allocateStack(&stackSize);
+            }
+        }
+        if(gThreads[id].stack == NULL) {
+            return -1;
+        }
+        gThreads[id].stackSize = stackSize;
+    }
+
+    for(i = 0; i < gThreads[id].stackSize; i++) {
+        gThreads[id].stack[i] = STACK_FILL_PATTERN;
     }
+    return 0;
+}
+
+/**
+ * Takes the first free block, which is large enough. The rest of the block stays free, unless it is too small to hold a header.
+ * Without such a block, the stack is carved from the unused end of the arena.
+ */
+static uint8_t* scheduler_allocateStack(size_t* stackSize) {
+    StackBlock_t** link = &gFreeStacks;
+    uint8_t* stack;
 
-    return THREAD_ID_INVALID;
+    while(*link != NULL && (*link)->size < *stackSize) {
+        link = &(*link)->next;
+    }
+    if(*link != NULL) {
+        StackBlock_t* block = *link;
+        stack = (uint8_t*)block;
+        if(block->size - *stackSize >= sizeof(StackBlock_t)) {
+            StackBlock_t* rest = (StackBlock_t*)(stack + *stackSize);
+            rest->next = block->next;
+            rest->size = block->size - *stackSize;
+            *link = rest;
+        } else {
+            *stackSize = block->size;
+            *link = block->next;
+        }
+        return stack;
+    }
+    if(PORT_STACK_ARENA_SIZE - gStackArenaUsed < *stackSize) {
+        return NULL;
+    }
+    stack = PORT_STACK_ARENA + gStackArenaUsed;
+    gStackArenaUsed += *stackSize;
+    return stack;
 }
 
 /**
- * Invalidates the slot in the threadpool of the current thread to release its resources.
+ * Inserts the stack into the sorted free blocks and merges it with its neighbours. A free block at the end of the used part of the arena
+ * is given back to the unused end, so a later large stack can be carved from there.
+ */
+static void scheduler_releaseStack(uint8_t* stack, size_t stackSize) {
+    StackBlock_t** link = &gFreeStacks;
+    StackBlock_t* previous = NULL;
+    StackBlock_t* block = (StackBlock_t*)stack;
+
+    while(*link != NULL && (uint8_t*)*link < stack) {
+        previous = *link;
+        link = &(*link)->next;
+    }
+    block->size = stackSize;
+    block->next = *link;
+    *link = block;
+    if(block->next != NULL && stack + block->size == (uint8_t*)block->next) {
+        block->size += block->next->size;
+        block->next = block->next->next;
+    }
+    if(previous != NULL && (uint8_t*)previous + previous->size == stack) {
+        previous->size += block->size;
+        previous->next = block->next;
+        block = previous;
+    }
+    if((uint8_t*)block + block->size == PORT_STACK_ARENA + gStackArenaUsed) {
+        gStackArenaUsed -= block->size;
+        link = &gFreeStacks;
+        while(*link != block) {
+            link = &(*link)->next;
+        }
+        *link = NULL;
+    }
+}
+
+/**
+ * Invalidates the slot in the threadpool of the current thread to release its resources and returns it to the list of free slots.
  */
 static void scheduler_killThread(void) {
     unsigned short s;
     ATOMIC_START(s);
     gThreads[gRunningThread].state = THREADSTATE_INVALID;
+    gThreads[gRunningThread].next = gFreeSlots;
+    gFreeSlots = gRunningThread;
     scheduler_runNextThread();
     ATOMIC_END(s);
 }
@@ -168,30 +708,195 @@ static void scheduler_killThread(void) {
  */
 void scheduler_blockThread(ThreadID_t id) {
     gThreads[id].state = THREADSTATE_BLOCKED;
+    TRACE(TRACE_EVENT_BLOCKED, id, 0);
     scheduler_runNextThread();
 }
 
 /**
- * Mark a blocked thread with the specified id as ready to be continued.
+ * Mark a blocked or sleeping thread with the specified id as ready to be continued and append it to the ready queue of its priority.
+ * A thread of a higher priority than the running thread preempts it through a deferred switch. If it is the first ready thread of the priority
+ * of the running thread, the running thread gets a new time slice and the timer is reprogrammed to end it.
  */
 void scheduler_resumeThread(ThreadID_t id) {
-    gThreads[id].state = THREADSTATE_READY;
+    if(gThreads[id].state == THREADSTATE_BLOCKED || gThreads[id].state == THREADSTATE_SLEEPING) {
+        ThreadPriority_t priority = gThreads[gRunningThread].priority;
+        unsigned char firstPeer = gThreads[id].priority == priority && !(gReadyBitmap & (1 << priority));
+#if THREAD_STATISTICS
+        gThreads[id].resumeTime = port_getTimestamp();
+        gThreads[id].resumed = 1;
+#endif
+        gThreads[id].state = THREADSTATE_READY;
+        TRACE(TRACE_EVENT_READY, id, 0);
+        scheduler_enqueueReadyThread(id);
+        if(firstPeer && gThreads[gRunningThread].state == THREADSTATE_RUNNING) {
+            scheduler_startTimeSlice(gRunningThread);
+        }
+        scheduler_checkPreemption();
+    }
+}
+
+#if THREAD_STATISTICS
+/**
+ * Copies the runtime statistics of a thread. The run time of the running thread is accounted first, so it is up to date.
+ * This is an atomic function.
+ */
+int scheduler_getStatistics(ThreadID_t id, ThreadStatistics_t* statistics) {
+    unsigned short s;
+    if(id >= THREADPOOL_SIZE) {
+        return -1;
+    }
+    ATOMIC_START(s);
+    scheduler_accountRunTime(gRunningThread);
+    *statistics = gThreads[id].statistics;
+    ATOMIC_END(s);
+    return 0;
+}
+
+/**
+ * Adds the time since the last switch to the run time of a thread. While the CPU is idling the time is not added, so this only restarts the accounting.
+ */
+static void scheduler_accountRunTime(ThreadID_t id) {
+    uint32_t now = port_getTimestamp();
+    if(!gIdling) {
+        gThreads[id].statistics.runTime += now - gLastSwitchTime;
+    }
+    gLastSwitchTime = now;
+}
+
+/**
+ * Records the wake-up latency of a thread from the time it was resumed until now, if it has been resumed at all.
+ * The latency is measured from the last switch, which is the time the thread actually starts running.
+ */
+static void scheduler_accountWakeup(ThreadID_t id) {
+    if(gThreads[id].resumed) {
+        uint32_t latency = gLastSwitchTime - gThreads[id].resumeTime;
+        gThreads[id].resumed = 0;
+        gThreads[id].statistics.wakeups++;
+        gThreads[id].statistics.wakeLatencyTotal += latency;
+        if(latency > gThreads[id].statistics.wakeLatencyMax) {
+            gThreads[id].statistics.wakeLatencyMax = latency > 0xFFFF ? 0xFFFF : latency;
+        }
+    }
+}
+#endif
+
+/**
+ * Initializes an empty queue of waiting threads with the specified order.
+ */
+void scheduler_initQueue(ThreadQueue_t* queue, ThreadQueueOrder_t order) {
+    queue->head = THREAD_ID_INVALID;
+    queue->tail = THREAD_ID_INVALID;
+    queue->order = order;
 }
 
 /**
- * Implementation of the callback function for every "system tick". This function decrements the sleep time of all sleeping threads
- * and calls the runNextThread function. The callback is called from the launchpad timer interrupt.
+ * Blocks the current thread and adds it to the specified queue. The queue is linked through the threads, so there is no limit
+ * on the number of waiting threads. This is an atomic function.
+ */
+void scheduler_blockThreadInQueue(ThreadQueue_t* queue) {
+    unsigned short s;
+    ATOMIC_START(s);
+    scheduler_enqueue(queue, gRunningThread);
+    scheduler_blockThread(gRunningThread);
+    ATOMIC_END(s);
+}
+
+/**
+ * Blocks the current thread in the specified queue and additionally inserts it into the sleep queue with the timeout as wake-up time.
+ * If the timeout expires first, timerCallback removes the thread from the queue, but leaves waitQueue set, so the thread can tell
+ * both cases apart. A resumed thread has already been removed from the sleep queue by scheduler_resumeQueuedThread.
+ * Returns 0 if the thread has been resumed and -1 if the timeout expired. This is an atomic function.
+ */
+int scheduler_blockThreadInQueueTimeout(ThreadQueue_t* queue, uint16_t timeout) {
+    unsigned short s;
+    int err = 0;
+    ATOMIC_START(s);
+    scheduler_enqueue(queue, gRunningThread);
+    gThreads[gRunningThread].waitQueue = queue;
+    gThreads[gRunningThread].wakeTime = port_getSystemTicks() + timeout;
+    scheduler_insertSleepingThread(gRunningThread);
+    if(gSleepingThreads == gRunningThread) {
+        scheduler_programTimer();
+    }
+    scheduler_blockThread(gRunningThread);
+    if(gThreads[gRunningThread].waitQueue != NULL) {
+        gThreads[gRunningThread].waitQueue = NULL;
+        err = -1;
+    }
+    ATOMIC_END(s);
+    return err;
+}
+
+/**
+ * Resumes the first thread of the specified queue and returns its ThreadID_t. Returns THREAD_ID_INVALID if the queue is empty.
+ * A thread waiting with a timeout is removed from the sleep queue as well. This is an atomic function.
+ */
+ThreadID_t scheduler_resumeQueuedThread(ThreadQueue_t* queue) {
+    unsigned short s;
+    ATOMIC_START(s);
+    ThreadID_t id = scheduler_dequeue(queue);
+    if(id != THREAD_ID_INVALID) {
+        if(gThreads[id].waitQueue != NULL) {
+            scheduler_removeSleepingThread(id);
+            gThreads[id].waitQueue = NULL;
+        }
+        scheduler_resumeThread(id);
+    }
+    ATOMIC_END(s);
+    return id;
+}
+
+/**
+ * Moves a waiting thread to the position matching its current priority by removing it from the queue and adding it again.
+ * A FIFO queue is not affected by priorities and is left unchanged. This is an atomic function.
+ */
+void scheduler_reorderQueuedThread(ThreadQueue_t* queue, ThreadID_t id) {
+    unsigned short s;
+    ATOMIC_START(s);
+    if(queue->order == THREADQUEUE_PRIORITY && scheduler_removeFromQueue(queue, id) == 0) {
+        scheduler_enqueue(queue, id);
+    }
+    ATOMIC_END(s);
+}
+
+/**
+ * Implementation of the callback function for the timer deadlines requested by the scheduler. This function wakes up every thread
+ * at the head of the sleep queue whose wake-up time has been reached and requests the next deadline. A thread whose wait with timeout expired
+ * is removed from its wait queue first. Woken threads of a higher priority and the end of the time slice, while a thread of the same priority
+ * is waiting, request a deferred switch, so the callback itself never switches. It is called from the timer interrupt of the port.
  */
 void timerCallback(uint16_t time) {
-    unsigned int i;
-    for (i = 0; i < THREADPOOL_SIZE; i++) {
-        if(gThreads[i].state == THREADSTATE_SLEEPING) {
-            if(gThreads[i].sleepTime > time) {
-                gThreads[i].sleepTime -= time;
-            } else {
-                scheduler_resumeThread(i);
-            }
+    uint32_t now = port_getSystemTicks();
+    (void)time;                                                     //The absolute system ticks decide which deadlines have been reached
+    while(gSleepingThreads != THREAD_ID_INVALID && (int32_t)(gThreads[gSleepingThreads].wakeTime - now) <= 0) {
+        ThreadID_t id = gSleepingThreads;
+        gSleepingThreads = gThreads[id].sleepNext;
+        if(gThreads[id].waitQueue != NULL) {
+            scheduler_removeFromQueue(gThreads[id].waitQueue, id);
         }
+        scheduler_resumeThread(id);
+    }
+    if(gThreads[gRunningThread].state == THREADSTATE_RUNNING && (gReadyBitmap & (1 << gThreads[gRunningThread].priority))
+            && (int32_t)(now - gSliceEnd) >= 0) {
+        port_requestSwitch();
+    }
+    scheduler_programTimer();
+}
+
+/**
+ * Implementation of the callback function for the deferred switches requested by the scheduler. The request may be outdated, because
+ * the running thread may have switched on its own meanwhile, so the reason is checked again: a ready thread of a higher priority or
+ * the end of the time slice, while a thread of the same priority is waiting. The callback is called from the switch interrupt of the port.
+ */
+void switchCallback(void) {
+    ThreadPriority_t priority = gThreads[gRunningThread].priority;
+    ThreadPriority_t highest;
+
+    if(gThreads[gRunningThread].state != THREADSTATE_RUNNING || gReadyBitmap == 0) {
+        return;
+    }
+    highest = scheduler_getHighestReadyPriority();
+    if(highest > priority || (highest == priority && (int32_t)(port_getSystemTicks() - gSliceEnd) >= 0)) {
+        scheduler_runNextThread();
     }
-    scheduler_runNextThread();
 }
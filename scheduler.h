@@ -16,9 +16,10 @@
 void scheduler_init(void);
 
 /**
- * Starts a new thread that executes the specified function and returns the assigned ThreadID_t.
+ * Starts a new thread with the specified priority and stack size in bytes that executes the specified function and returns the assigned ThreadID_t.
+ * The priority ranges from THREAD_PRIORITY_LOWEST to THREAD_PRIORITY_HIGHEST. Returns THREAD_ID_INVALID if there is no free slot or not enough stack memory left.
  */
-ThreadID_t scheduler_startThread(ThreadFunction_t tFunc);
+ThreadID_t scheduler_startThread(ThreadFunction_t tFunc, ThreadPriority_t priority, size_t stackSize);
 
 /**
  * Returns the ThreadID_t of the currently running thread.
@@ -26,7 +27,38 @@ ThreadID_t scheduler_startThread(ThreadFunction_t tFunc);
 ThreadID_t scheduler_getRunningThread(void);
 
 /**
- * Saves the current thread state and runs a different thread according to the round robin principle.
+ * Returns the peak stack usage in bytes of the thread with the specified ThreadID_t. The main thread does not run on a stack of the arena and returns 0.
+ */
+size_t scheduler_getStackUsage(ThreadID_t id);
+
+#if THREAD_STATISTICS
+/**
+ * Copies the runtime statistics of the thread with the specified ThreadID_t. Returns -1 if the ThreadID_t is invalid.
+ */
+int scheduler_getStatistics(ThreadID_t id, ThreadStatistics_t* statistics);
+#endif
+
+/**
+ * Returns the current priority of the thread with the specified ThreadID_t.
+ */
+ThreadPriority_t scheduler_getPriority(ThreadID_t id);
+
+/**
+ * Changes the priority of the thread with the specified ThreadID_t. A ready thread is moved to the ready queue of its new priority.
+ * This does not switch to a different thread right away. If a ready thread has a higher priority than the running thread afterwards,
+ * the switch happens as soon as global interrupts are enabled again.
+ */
+void scheduler_setPriority(ThreadID_t id, ThreadPriority_t priority);
+
+/**
+ * Sets the time slice of the thread with the specified ThreadID_t in system ticks, after which it gives way to a ready thread of the same priority.
+ * Every thread starts with PORT_TIMER_INTERVAL. A time slice of 0 is treated as 1.
+ */
+void scheduler_setTimeSlice(ThreadID_t id, uint16_t timeSlice);
+
+/**
+ * Saves the current thread state and runs the ready thread with the highest priority.
+ * Threads of the same priority are run according to the round robin principle.
  */
 void scheduler_runNextThread(void);
 
@@ -45,4 +77,30 @@ void scheduler_blockThread(ThreadID_t id);
  */
 void scheduler_resumeThread(ThreadID_t id);
 
+/**
+ * Initializes an empty queue of waiting threads with the specified order.
+ */
+void scheduler_initQueue(ThreadQueue_t* queue, ThreadQueueOrder_t order);
+
+/**
+ * Blocks the current thread and appends it to the specified queue until it is resumed with scheduler_resumeQueuedThread.
+ */
+void scheduler_blockThreadInQueue(ThreadQueue_t* queue);
+
+/**
+ * Blocks the current thread in the specified queue for at most the timeout in milliseconds (approx).
+ * Returns 0 if it has been resumed with scheduler_resumeQueuedThread and -1 if the timeout expired.
+ */
+int scheduler_blockThreadInQueueTimeout(ThreadQueue_t* queue, uint16_t timeout);
+
+/**
+ * Resumes the first thread of the specified queue and returns its ThreadID_t. Returns THREAD_ID_INVALID if the queue is empty.
+ */
+ThreadID_t scheduler_resumeQueuedThread(ThreadQueue_t* queue);
+
+/**
+ * Moves a thread waiting in the specified queue to the position matching its current priority, after its priority has been changed.
+ */
+void scheduler_reorderQueuedThread(ThreadQueue_t* queue, ThreadID_t id);
+
 #endif /* SCHEDULER_H_ */
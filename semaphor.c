@@ -7,63 +7,81 @@
 
 #include "scheduler.h"
 #include "semaphor.h"
-#include "drivers/launchpad.h"
-
-//Helper functions to use the bitwise queue
-static inline void semaphor_enqueue(Semaphor_t* semaphor, ThreadID_t id);
-static inline ThreadID_t semaphor_dequeue(Semaphor_t* semaphor);
+#include "port/port.h"
+#include "trace.h"
 
 /**
- * Initializes a semaphor by initializing the struct variables with 0.
+ * Initializes a semaphor by initializing the counter with 0 and an empty FIFO queue.
  */
 void semaphor_init(Semaphor_t* semaphor) {
+    semaphor_initOrdered(semaphor, THREADQUEUE_FIFO);
+}
+
+/**
+ * Initializes a semaphor by initializing the counter with 0 and an empty queue with the specified order.
+ */
+void semaphor_initOrdered(Semaphor_t* semaphor, ThreadQueueOrder_t order) {
     semaphor->counter = 0;
-    semaphor->queueCount = 0;
-    semaphor->queue = 0;
+    scheduler_initQueue(&semaphor->queue, order);
 }
 
 /**
  * Blocking function for a semaphor. This is an atomic function which blocks the current thread until semaphor_V is called.
+ * The thread waits in the queue of the semaphor.
  */
 void semaphor_P(Semaphor_t* semaphor) {
     unsigned short s;
     ATOMIC_START(s);
+    TRACE(TRACE_EVENT_SEMAPHOR_P, TRACE_THREAD_NONE, (uint16_t)(uintptr_t)semaphor);
     semaphor->counter--;
     if(semaphor->counter < 0) {
-        ThreadID_t id = scheduler_getRunningThread();
-        semaphor_enqueue(semaphor, id);
-        scheduler_blockThread(id);
+        scheduler_blockThreadInQueue(&semaphor->queue);
     }
     ATOMIC_END(s);
 }
 
 /**
- * Releasing function for a semaphor. This is an atomic function which releases the block from blocked threads.
+ * Blocking function for a semaphor with a timeout. This is an atomic function which blocks the current thread until semaphor_V is called
+ * or the timeout expires. On a timeout the thread has already been removed from the queue, so only the counter has to be restored.
+ * A timeout of 0 does not block at all.
  */
-void semaphor_V(Semaphor_t* semaphor) {
+int semaphor_timedP(Semaphor_t* semaphor, uint16_t timeout) {
     unsigned short s;
+    int err = 0;
     ATOMIC_START(s);
-    semaphor->counter++;
-    if (semaphor->counter <= 0) {
-        scheduler_resumeThread(semaphor_dequeue(semaphor));
+    TRACE(TRACE_EVENT_SEMAPHOR_P, TRACE_THREAD_NONE, (uint16_t)(uintptr_t)semaphor);
+    if(semaphor->counter > 0) {
+        semaphor->counter--;
+    } else if(timeout == 0) {
+        err = -1;
+    } else {
+        semaphor->counter--;
+        if(scheduler_blockThreadInQueueTimeout(&semaphor->queue, timeout) != 0) {
+            semaphor->counter++;
+            err = -1;
+        }
     }
     ATOMIC_END(s);
+    return err;
 }
 
 /**
- * Helper function to enqueue a ThreadID_t into the bitwise queue of a semaphor.
+ * Non-blocking function for a semaphor. This is an atomic function which only takes the semaphor if no thread would have to wait.
  */
-static inline void semaphor_enqueue(Semaphor_t* semaphor, ThreadID_t id) {
-    semaphor->queue |= id << (semaphor->queueCount++ * 4);                  //shift the id into the queue by queue count times 4bit and then increment the counter
+int semaphor_tryP(Semaphor_t* semaphor) {
+    return semaphor_timedP(semaphor, 0);
 }
 
 /**
- * Helper function to dequeue a ThreadID_t from a bitwise queue of a semaphor.
- *
+ * Releasing function for a semaphor. This is an atomic function which releases the block from the first thread in the queue.
  */
-static inline ThreadID_t semaphor_dequeue(Semaphor_t* semaphor) {
-    ThreadID_t id = semaphor->queue & 0x000F;                               //extract the last 4 bit of the queue
-    semaphor->queue >>= 4;                                                  //shift the whole queue right by 4 bit
-    semaphor->queueCount--;                                                 //decrement the counter
-    return id;
+void semaphor_V(Semaphor_t* semaphor) {
+    unsigned short s;
+    ATOMIC_START(s);
+    TRACE(TRACE_EVENT_SEMAPHOR_V, TRACE_THREAD_NONE, (uint16_t)(uintptr_t)semaphor);
+    semaphor->counter++;
+    if (semaphor->counter <= 0) {
+        scheduler_resumeQueuedThread(&semaphor->queue);
+    }
+    ATOMIC_END(s);
 }
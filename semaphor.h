@@ -9,22 +9,38 @@
 #ifndef SEMAPHOR_H_
 #define SEMAPHOR_H_
 
+#include "thread.h"
+
 typedef struct {                        //Defines the control block of a semaphor
     int counter;
-    unsigned char queueCount;
-    unsigned short queue;
+    ThreadQueue_t queue;
 } Semaphor_t;
 
 /**
- * Initializer function for a semaphor.
+ * Initializer function for a semaphor. Blocked threads are released in FIFO order.
  */
 void semaphor_init(Semaphor_t* semaphor);
 
+/**
+ * Initializer function for a semaphor, whose blocked threads are released in the specified order.
+ */
+void semaphor_initOrdered(Semaphor_t* semaphor, ThreadQueueOrder_t order);
+
 /**
  * Blocking function for a semaphor.
  */
 void semaphor_P(Semaphor_t* semaphor);
 
+/**
+ * Blocking function for a semaphor, which gives up after the timeout in milliseconds (approx). Returns 0 if the semaphor has been taken and -1 if the timeout expired.
+ */
+int semaphor_timedP(Semaphor_t* semaphor, uint16_t timeout);
+
+/**
+ * Non-blocking function for a semaphor. Returns 0 if the semaphor has been taken and -1 otherwise.
+ */
+int semaphor_tryP(Semaphor_t* semaphor);
+
 /**
  * Releasing function for a semaphor.
  */
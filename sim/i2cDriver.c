@@ -0,0 +1,141 @@
+/*
+ * i2cDriver.c
+ *
+ *  This file implements i2cDriver.h for the simulated launchpad. Transactions complete right away and are answered by a model of the SHT21,
+ *  which is the only device on the simulated bus. The model follows the "no hold master" mode: a triggered measurement takes
+ *  SHT21_CONVERSION_TIME and the sensor does not acknowledge its address until the result is ready. A result can be read once.
+ *
+ */
+
+#if defined(LAUNCHPAD_SIMULATOR)
+
+#include "i2cDriver.h"
+#include "sensorDriver.h"
+#include "launchpad.h"
+#include "simulator.h"
+
+#define SHT21_CONVERSION_TIME           85                      //Defines the time in system ticks of a 14 bit temperature measurement
+
+typedef enum {                                                  //Defines the states of the simulated SHT21
+    SHT21STATE_IDLE,                                            //No result available
+    SHT21STATE_MEASURING,                                       //Measurement triggered, the address is not acknowledged
+    SHT21STATE_READY                                            //Result available
+} Sht21State_t;
+
+static Sht21State_t gSensorState = SHT21STATE_IDLE;             //Current state of the simulated SHT21
+static uint32_t gMeasureStart = 0;                              //System ticks at which the measurement was triggered
+static uint16_t gSensorValue = 0;                               //Sensor value of the measurement
+
+/**
+ * Runs a transaction on the simulated bus and returns its result.
+ */
+static I2CStatus_t i2cDriver_runTransfer(I2CTransfer_t* transfer);
+
+/**
+ * Calculates the CRC-8 of the SHT21 over the specified bytes.
+ */
+static uint8_t i2cDriver_crc(const uint8_t* data, size_t length);
+
+/**
+ * Resets the simulated SHT21.
+ */
+void i2cDriver_init(void) {
+    gSensorState = SHT21STATE_IDLE;
+}
+
+/**
+ * Runs a transaction right away and releases the waiting thread. This is an atomic function.
+ */
+void i2cDriver_submit(I2CTransfer_t* transfer) {
+    unsigned short s;
+    transfer->next = NULL;
+    semaphor_init(&transfer->done);
+    ATOMIC_START(s);
+    transfer->status = i2cDriver_runTransfer(transfer);
+    ATOMIC_END(s);
+    semaphor_V(&transfer->done);
+}
+
+/**
+ * Blocks the calling thread until a submitted transaction is complete, which it always is in the simulator.
+ */
+I2CStatus_t i2cDriver_wait(I2CTransfer_t* transfer) {
+    semaphor_P(&transfer->done);
+    return transfer->status;
+}
+
+/**
+ * Submits a transaction and blocks the calling thread until it is complete.
+ */
+I2CStatus_t i2cDriver_transfer(I2CTransfer_t* transfer) {
+    i2cDriver_submit(transfer);
+    return i2cDriver_wait(transfer);
+}
+
+/**
+ * Runs a transaction with the simulated SHT21. The write triggers a measurement of the current temperature of the script,
+ * the read returns the sensor value with the status bits of a temperature and the checksum.
+ */
+static I2CStatus_t i2cDriver_runTransfer(I2CTransfer_t* transfer) {
+    int32_t value;
+    size_t i;
+
+    if(transfer->address != TEMPERATURE_SENSOR_ADDRESS) {
+        return I2C_ERROR_NACK;
+    }
+    if(gSensorState == SHT21STATE_MEASURING && (int32_t)(launchpad_getSystemTicks() - gMeasureStart) >= SHT21_CONVERSION_TIME) {
+        gSensorState = SHT21STATE_READY;
+    }
+    if(gSensorState == SHT21STATE_MEASURING) {
+        return I2C_ERROR_NACK;
+    }
+
+    if(transfer->txLen > 0) {
+        if(transfer->txLen != 1 || transfer->txBuf[0] != TEMPERATURE_SENSOR_COMMAND) {
+            return I2C_ERROR_NACK;
+        }
+        value = (simulator_getTemperature() + 4685) * 65536 / 17572;    //Inverse of T = -46.85 + 175.72 * value / 2^16
+        if(value < 0) {
+            value = 0;
+        }
+        if(value > 0xFFFF) {
+            value = 0xFFFF;
+        }
+        gSensorValue = (uint16_t)value & ~0x0003;                                //Status bits of a temperature are 0
+        gMeasureStart = launchpad_getSystemTicks();
+        gSensorState = SHT21STATE_MEASURING;
+        return transfer->rxLen > 0 ? I2C_ERROR_NACK : I2C_OK;
+    }
+
+    if(transfer->rxLen > 0) {
+        uint8_t result[3];
+        if(gSensorState != SHT21STATE_READY) {
+            return I2C_ERROR_NACK;
+        }
+        result[0] = gSensorValue >> 8;
+        result[1] = gSensorValue & 0xFF;
+        result[2] = i2cDriver_crc(result, 2);
+        for(i = 0; i < transfer->rxLen; i++) {
+            transfer->rxBuf[i] = i < 3 ? result[i] : 0xFF;
+        }
+        gSensorState = SHT21STATE_IDLE;
+    }
+    return I2C_OK;
+}
+
+/**
+ * Calculates the CRC-8 of the SHT21 bit by bit with an initial value of 0.
+ */
+static uint8_t i2cDriver_crc(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    uint8_t bit;
+    while(length-- > 0) {
+        crc ^= *data++;
+        for(bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ TEMPERATURE_SENSOR_CRC_POLYNOMIAL : crc << 1;
+        }
+    }
+    return crc;
+}
+
+#endif /* LAUNCHPAD_SIMULATOR */
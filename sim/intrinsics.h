@@ -0,0 +1,13 @@
+/*
+ * intrinsics.h
+ *
+ *  This file replaces the intrinsics of the TI compiler for the simulated launchpad. They are declared together with the register file in "msp430.h".
+ *
+ */
+
+#ifndef SIM_INTRINSICS_H_
+#define SIM_INTRINSICS_H_
+
+#include "msp430.h"
+
+#endif /* SIM_INTRINSICS_H_ */
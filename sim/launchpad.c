@@ -0,0 +1,671 @@
+/*
+ * launchpad.c
+ *
+ *  This file implements launchpad.h for the simulated launchpad. It contains the simulated register file, the virtual time of TimerA0
+ *  and the script, which controls the temperature and the button. The LED, display, button and sensor drivers run unchanged on the register file.
+ *
+ *  Virtual time only advances in launchpad_idle: the time jumps to the next interrupt, which is the deadline of the system timer,
+ *  the capture/compare register 1 or the next line of the script. Every change of the LCD memory and the LEDs is recorded with its system ticks
+ *  on stdout, so two runs of the same script can be compared line by line.
+ *
+ *  The script is read from the file in the environment variable LAUNCHPAD_SIM_SCRIPT. Every line contains the system ticks at which
+ *  it takes effect followed by a command. The points of the temperature curve and the other commands have to be in chronological order
+ *  on their own, '#' starts a comment:
+ *
+ *      <ticks> temperature <celsius>   Point of the temperature curve, the temperature is interpolated linearly between two points
+ *      <ticks> press                   The button is pressed
+ *      <ticks> release                 The button is released
+ *      <ticks> end                     The simulation ends, otherwise it ends with the last line
+ *
+ */
+
+#if defined(LAUNCHPAD_SIMULATOR)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "launchpad.h"
+#include "LEDDriver.h"
+#include "displayDriver.h"
+#include "i2cDriver.h"
+#include "uartDriver.h"
+#include "telemetry.h"
+#include "temperatureConverter.h"
+#include "simulator.h"
+#include "../trace.h"
+
+#define SIM_LINE_LENGTH             128                                             //Defines the maximum length of a line of the script
+
+typedef enum {                                                                      //Defines the commands of the script, which change the board
+    SIMEVENT_PRESS,
+    SIMEVENT_RELEASE,
+    SIMEVENT_END
+} SimEventType_t;
+
+typedef struct {                                                                    //Defines a line of the script, which changes the board
+    uint32_t time;                                                                  //System ticks at which the event occurs
+    SimEventType_t type;
+} SimEvent_t;
+
+typedef struct {                                                                    //Defines a point of the temperature curve
+    uint32_t time;                                                                  //System ticks of the point
+    int32_t temperature;                                                            //Temperature in 1/100 degree Celsius
+} SimTemperature_t;
+
+volatile uint8_t P1IN;                                                              //Simulated register file
+volatile uint8_t P1OUT;
+volatile uint8_t P1DIR;
+volatile uint8_t P1REN;
+volatile uint8_t P1SEL0;
+volatile uint8_t P1IE;
+volatile uint8_t P1IES;
+volatile uint8_t P1IFG;
+volatile uint8_t P9OUT;
+volatile uint8_t P9DIR;
+volatile uint16_t TA0CCTL1;
+volatile uint16_t TA0CCR1;
+volatile uint8_t gLCDMemory[LCD_MEMORY_SIZE + 1];
+volatile uint16_t LCDCCTL0;
+volatile uint16_t LCDCPCTL0;
+volatile uint16_t LCDCPCTL1;
+volatile uint16_t LCDCPCTL2;
+volatile uint16_t LCDCMEMCTL;
+
+static unsigned short gInterruptState = 0;                                          //Simulated global interrupt enable flag
+static unsigned char gSwitchRequested = 0;                                          //Set while the simulated switch interrupt is pending
+static uint64_t gTimerCounts = 0;                                                   //Virtual time in counts of TimerA0 since the start of the simulation
+static uint32_t gSystemTicks = 0;                                                   //System ticks at the time of the last timer interrupt
+static uint64_t gLastCompare = 0;                                                   //Timer counts of the last timer interrupt
+static uint16_t gTimerInterval = LAUNCHPAD_TIMER_MAX_INTERVAL;                      //System ticks between the last and the next timer interrupt
+static uint16_t gSMCLKRequests = 0;                                                 //Number of drivers that require SMCLK while the CPU is idle
+static uint32_t gLPM0Time = 0;                                                      //Timer counts spent in LPM0
+static uint32_t gLPM3Time = 0;                                                      //Timer counts spent in LPM3
+
+static SimEvent_t* gEvents = NULL;                                                  //Events of the script
+static size_t gEventCount = 0;
+static size_t gNextEvent = 0;                                                       //Index of the next event, which has not occurred yet
+static SimTemperature_t* gTemperatures = NULL;                                      //Temperature curve of the script
+static size_t gTemperatureCount = 0;
+static size_t gTemperatureIndex = 0;                                                //Index of the last point not later than the virtual time
+
+static uint8_t gRecordedLCD[LCD_MEMORY_SIZE + 1];                                   //LCD memory at the time of the last record
+static uint8_t gRecordedLEDs = 0xFF;                                                //State of the LEDs at the time of the last record
+
+/**
+ * The timer callback is to be implemented by the OS and is being called every time the deadline requested with launchpad_setTimerDeadline is reached.
+ * The parameter contains the system ticks passed since the last execution.
+ */
+extern void timerCallback(uint16_t time);
+
+/**
+ * The switch callback is to be implemented by the OS and is being called by the switch interrupt requested with launchpad_requestSwitch.
+ */
+extern void switchCallback(void);
+
+/**
+ * The interrupt of port 1, which is implemented by the buttonDriver.
+ */
+extern void PORT1_ISR(void);
+
+/**
+ * Reads the script from the file in the environment variable. Without a script the default temperature is simulated for the default duration.
+ */
+static void launchpad_loadScript(void);
+
+/**
+ * Appends an event to the script.
+ */
+static void launchpad_appendEvent(uint32_t time, SimEventType_t type);
+
+/**
+ * Executes the events of the script at the current virtual time.
+ */
+static void launchpad_runScript(void);
+
+/**
+ * Changes the level of the button pin and sets the interrupt flag on the selected edge.
+ */
+static void launchpad_setButtonPin(unsigned char pressed);
+
+/**
+ * Executes the interrupt of port 1 if it is pending. Returns 1 if the interrupt has been executed.
+ */
+static unsigned char launchpad_servicePortInterrupt(void);
+
+/**
+ * Executes the switch interrupt if it is pending.
+ */
+static void launchpad_serviceSwitchInterrupt(void);
+
+/**
+ * Records every change of the LCD memory and the LEDs since the last record.
+ */
+static void launchpad_recordState(void);
+
+/**
+ * Records the final state and the statistics and terminates the simulation.
+ */
+static void launchpad_finish(void);
+
+/**
+ * Initializes the simulated launchpad. The register file is reset to the state after power up with the button released,
+ * the script is loaded and the drivers are initialized like on the launchpad.
+ */
+void launchpad_init(void) {
+    P1IN = 0xFF;                                                                    //The pull-up keeps the button pin high
+    P1OUT = P1DIR = P1REN = P1SEL0 = P1IE = P1IES = P1IFG = 0;
+    P9OUT = P9DIR = 0;
+    TA0CCTL1 = TA0CCR1 = 0;
+    memset((void*)gLCDMemory, 0, sizeof(gLCDMemory));
+    memset(gRecordedLCD, 0, sizeof(gRecordedLCD));
+    launchpad_loadScript();
+
+    ledDriver_init();                                                               //Initialize green and red LED
+    displayDriver_init();                                                           //Initialize required display segments
+    launchpad_clearDisplay();
+    buttonDriver_init();                                                            //Initialize button 1
+    gTimerCounts = 0;                                                               //Initialize timer
+    gSystemTicks = 0;
+    gLastCompare = 0;
+    gTimerInterval = LAUNCHPAD_TIMER_MAX_INTERVAL;
+    i2cDriver_init();                                                               //Initialize the I2C bus
+    uartDriver_init();                                                              //Initialize the backchannel UART
+}
+
+/**
+ * Returns the current system ticks, which are derived from the virtual time like from the timer count on the launchpad.
+ */
+uint32_t launchpad_getSystemTicks(void) {
+    return gSystemTicks + (uint32_t)((gTimerCounts - gLastCompare) >> LAUNCHPAD_TICK_SHIFT);
+}
+
+/**
+ * Returns the virtual time in counts of TimerA0.
+ */
+uint32_t launchpad_getTimestamp(void) {
+    return (uint32_t)gTimerCounts;
+}
+
+/**
+ * Returns the virtual time in counts of TimerA0, which never lags behind a wrap of the timer.
+ */
+uint32_t launchpad_getRawTimestamp(void) {
+    return (uint32_t)gTimerCounts;
+}
+
+/**
+ * Programs the deadline of the next timer interrupt relative to the last one, just like on the launchpad.
+ */
+void launchpad_setTimerDeadline(uint32_t deadline) {
+    int32_t interval = deadline - gSystemTicks;
+    uint32_t elapsed = (uint32_t)((gTimerCounts - gLastCompare) >> LAUNCHPAD_TICK_SHIFT);
+    if(interval > LAUNCHPAD_TIMER_MAX_INTERVAL) {
+        interval = LAUNCHPAD_TIMER_MAX_INTERVAL;
+    }
+    if(interval <= (int32_t)elapsed) {                                              //The deadline has already passed, so interrupt on the next tick
+        interval = elapsed + 1;
+    }
+    gTimerInterval = interval;
+}
+
+/**
+ * Returns the current count of TimerA0.
+ */
+uint16_t launchpad_getTimerCount(void) {
+    return (uint16_t)gTimerCounts;
+}
+
+/**
+ * Returns the microseconds of the monotonic clock of the host as cycle count, because the simulated CPU does not take any virtual time.
+ * The cycle count is not part of the recorded output, so it does not affect the comparison of two runs.
+ */
+uint16_t launchpad_getCycleCount(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint16_t)(now.tv_sec * 1000000ULL + now.tv_nsec / 1000);
+}
+
+/**
+ * Marks the simulated switch interrupt as pending. It is executed when the simulated global interrupts are enabled again.
+ */
+void launchpad_requestSwitch(void) {
+    gSwitchRequested = 1;
+}
+
+/**
+ * Advances the virtual time to the next interrupt and executes it. A pending interrupt of port 1 is executed without advancing the time.
+ * The time until the interrupt is added to the statistics of the low power mode, because the CPU does not take any virtual time.
+ * Several interrupts at the same time are executed in the order of the script, capture/compare register 1 and system timer.
+ */
+void launchpad_idle(void) {
+    uint64_t timer = gLastCompare + ((uint64_t)gTimerInterval << LAUNCHPAD_TICK_SHIFT);
+    uint64_t compare = UINT64_MAX;
+    uint64_t script = UINT64_MAX;
+    uint64_t next;
+
+    launchpad_recordState();
+    if(launchpad_servicePortInterrupt()) {
+        return;
+    }
+    if(TA0CCTL1 & CCIE) {
+        uint16_t counts = TA0CCR1 - (uint16_t)gTimerCounts;
+        compare = gTimerCounts + (counts == 0 ? 0x10000 : counts);
+    }
+    if(gNextEvent < gEventCount) {
+        script = (uint64_t)gEvents[gNextEvent].time << LAUNCHPAD_TICK_SHIFT;
+    }
+    next = timer < compare ? timer : compare;
+    next = script < next ? script : next;
+
+    if(gSMCLKRequests > 0) {
+        gLPM0Time += (uint32_t)(next - gTimerCounts);
+    } else {
+        gLPM3Time += (uint32_t)(next - gTimerCounts);
+    }
+    gTimerCounts = next;
+
+    if(next == script) {
+        launchpad_runScript();
+        launchpad_servicePortInterrupt();
+    }
+    if(next == compare) {
+        buttonDriver_timerInterrupt();
+    }
+    if(next == timer) {
+        uint16_t elapsed = gTimerInterval;
+        gSystemTicks += elapsed;
+        gLastCompare += (uint64_t)elapsed << LAUNCHPAD_TICK_SHIFT;
+        gTimerInterval = LAUNCHPAD_TIMER_MAX_INTERVAL;
+        TRACE(TRACE_EVENT_ISR_ENTER, TRACE_THREAD_NONE, TRACE_ISR_TIMER0_A0);
+        timerCallback(elapsed);
+        TRACE(TRACE_EVENT_ISR_EXIT, TRACE_THREAD_NONE, TRACE_ISR_TIMER0_A0);
+    }
+}
+
+/**
+ * Requests SMCLK to keep running while the CPU is idle. This is an atomic function.
+ */
+void launchpad_requestSMCLK(void) {
+    unsigned short s;
+    ATOMIC_START(s);
+    gSMCLKRequests++;
+    ATOMIC_END(s);
+}
+
+/**
+ * Releases a request of SMCLK. This is an atomic function.
+ */
+void launchpad_releaseSMCLK(void) {
+    unsigned short s;
+    ATOMIC_START(s);
+    if(gSMCLKRequests > 0) {
+        gSMCLKRequests--;
+    }
+    ATOMIC_END(s);
+}
+
+/**
+ * Copies the time spent in each power mode. The active time is the remaining time since the start of the simulation.
+ */
+void launchpad_getPowerStatistics(PowerStatistics_t* statistics) {
+    statistics->lpm0Time = gLPM0Time;
+    statistics->lpm3Time = gLPM3Time;
+    statistics->activeTime = (uint32_t)gTimerCounts - gLPM0Time - gLPM3Time;
+}
+
+/**
+ * Toggles the green LED by using the macro defined in the LEDDriver
+ */
+void launchpad_toggleGreenLED(void) {
+    LED_GREEN_TOGGLE;
+}
+
+/**
+ * Toggles the red LED by using the macro defined in the LEDDriver
+ */
+void launchpad_toggleRedLED(void) {
+    LED_RED_TOGGLE;
+}
+
+/**
+ * Enables/Disables the red LED by using the macro defined in the LEDDriver
+ */
+void launchpad_toggleRedLEDEnable(void) {
+    LED_RED_TOGGLE_ENABLE;
+}
+
+/**
+ * Display a temperature of specified unit on the LCD display by delegating to the displayDriver.
+ */
+void launchpad_showTemperature(uint16_t sensorValue, TemperatureUnit_t unit) {
+    displayDriver_showTemperature(sensorValue, unit);
+}
+
+/**
+ * Display the temperature of a sensor value of the SHT21 in the specified unit on the LCD display.
+ */
+void launchpad_showSensorValue(uint16_t sensorValue, TemperatureUnit_t unit) {
+    TemperatureDigits_t digits;
+    temperatureConverter_toDigits(sensorValue, unit, &digits);
+    displayDriver_showDigits(&digits, unit);
+}
+
+/**
+ * Clears the LCD display by delegating to the displayDriver. The LCD module clears its memory when LCDCLRM is set, which is done here.
+ */
+void launchpad_clearDisplay(void) {
+    displayDriver_clear();
+    if(LCDCMEMCTL & LCDCLRM) {
+        memset((void*)gLCDMemory, 0, sizeof(gLCDMemory));
+        LCDCMEMCTL &= ~LCDCLRM;
+    }
+}
+
+/**
+ * Triggers a temperature measurement of the simulated SHT21 by delegating to the sensorDriver.
+ */
+int launchpad_measureTemperature(void) {
+    return sensorDriver_measureTemperature();
+}
+
+/**
+ * Requests the result of a previously triggered temperature measurement by the sensorDriver.
+ */
+int launchpad_readTemperature(int16_t* sensorValue) {
+    return sensorDriver_readTemperature(sensorValue);
+}
+
+/**
+ * Copies the latest validated temperature sample of the sensorDriver.
+ */
+uint16_t launchpad_getTemperatureSample(TemperatureSample_t* sample) {
+    return sensorDriver_getLatestSample(sample);
+}
+
+/**
+ * Blocks the calling thread until the next event of the button 1 occurs by delegating to the buttonDriver.
+ */
+ButtonEvent_t launchpad_waitButtonEvent(void) {
+    return buttonDriver_waitEvent();
+}
+
+/**
+ * Returns the current state of the button 1 by using the macro defined in the buttonDriver.
+ */
+unsigned char launchpad_getButtonState(void) {
+    return BTN_STATE;
+}
+
+/**
+ * Sends a temperature sample on the telemetry stream by delegating to the telemetry driver.
+ */
+int launchpad_sendSample(const TemperatureSample_t* sample) {
+    return telemetry_sendSample(sample->timestamp, sample->value);
+}
+
+/**
+ * Sends the power statistics on the telemetry stream by delegating to the telemetry driver.
+ */
+int launchpad_sendPowerStatistics(void) {
+    PowerStatistics_t statistics;
+    launchpad_getPowerStatistics(&statistics);
+    return telemetry_sendPower(statistics.activeTime, statistics.lpm0Time, statistics.lpm3Time);
+}
+
+/**
+ * Sends a text on the telemetry stream by delegating to the telemetry driver.
+ */
+uint16_t launchpad_sendText(const char* text) {
+    return telemetry_sendText(text);
+}
+
+/**
+ * Returns the temperature of the script at the current virtual time. The index of the current point only moves forward, because the virtual time does.
+ */
+int32_t simulator_getTemperature(void) {
+    uint32_t now = launchpad_getSystemTicks();
+    const SimTemperature_t* previous;
+    const SimTemperature_t* next;
+
+    if(gTemperatureCount == 0) {
+        return SIMULATOR_DEFAULT_TEMPERATURE;
+    }
+    while(gTemperatureIndex + 1 < gTemperatureCount && gTemperatures[gTemperatureIndex + 1].time <= now) {
+        gTemperatureIndex++;
+    }
+    previous = &gTemperatures[gTemperatureIndex];
+    if(previous->time > now || gTemperatureIndex + 1 == gTemperatureCount) {
+        return previous->temperature;
+    }
+    next = previous + 1;
+    return previous->temperature + (int32_t)((int64_t)(next->temperature - previous->temperature) * (now - previous->time) / (next->time - previous->time));
+}
+
+/**
+ * Returns the state of the simulated global interrupt enable flag.
+ */
+unsigned short _get_interrupt_state(void) {
+    return gInterruptState;
+}
+
+/**
+ * Restores the simulated global interrupt enable flag. Interrupts only occur while the CPU is idle, so only the switch interrupt can be pending here.
+ */
+void _set_interrupt_state(unsigned short state) {
+    gInterruptState = state;
+    if(state) {
+        launchpad_serviceSwitchInterrupt();
+    }
+}
+
+/**
+ * Disables the simulated global interrupts.
+ */
+void _disable_interrupts(void) {
+    gInterruptState = 0;
+}
+
+/**
+ * Disables the simulated global interrupts.
+ */
+void __disable_interrupt(void) {
+    gInterruptState = 0;
+}
+
+/**
+ * Enables the simulated global interrupts.
+ */
+void __enable_interrupt(void) {
+    gInterruptState = GIE;
+    launchpad_serviceSwitchInterrupt();
+}
+
+/**
+ * Reads the script line by line. Temperatures are stored as points of the curve, every other command as an event. A malformed line terminates
+ * the simulation, because the results would not be meaningful.
+ */
+static void launchpad_loadScript(void) {
+    const char* path = getenv(SIMULATOR_SCRIPT_VARIABLE);
+    char line[SIM_LINE_LENGTH];
+    char command[SIM_LINE_LENGTH];
+    unsigned long time;
+    unsigned long lastTime = 0;
+    double celsius;
+    unsigned int lineNumber = 0;
+    FILE* file;
+
+    if(path == NULL) {
+        launchpad_appendEvent(SIMULATOR_DEFAULT_DURATION, SIMEVENT_END);
+        return;
+    }
+    file = fopen(path, "r");
+    if(file == NULL) {
+        fprintf(stderr, "cannot open the script %s\n", path);
+        exit(1);
+    }
+    while(fgets(line, sizeof(line), file) != NULL) {
+        char* comment = strchr(line, '#');
+        int fields;
+        lineNumber++;
+        if(comment != NULL) {
+            *comment = '\0';
+        }
+        fields = sscanf(line, "%lu %127s %lf", &time, command, &celsius);
+        if(fields <= 0) {
+            continue;
+        }
+        if(fields < 2 || (strcmp(command, "temperature") == 0 ? gTemperatureCount > 0 && time < gTemperatures[gTemperatureCount - 1].time
+                                                              : gEventCount > 0 && time < gEvents[gEventCount - 1].time)) {
+            fprintf(stderr, "%s:%u: expected '<ticks> <command>' in chronological order\n", path, lineNumber);
+            exit(1);
+        }
+        if(time > lastTime) {
+            lastTime = time;
+        }
+        if(strcmp(command, "temperature") == 0 && fields == 3) {
+            gTemperatures = realloc(gTemperatures, (gTemperatureCount + 1) * sizeof(SimTemperature_t));
+            if(gTemperatures == NULL) {
+                fprintf(stderr, "out of memory for the script\n");
+                exit(1);
+            }
+            gTemperatures[gTemperatureCount].time = time;
+            gTemperatures[gTemperatureCount].temperature = (int32_t)(celsius * 100.0 + (celsius < 0 ? -0.5 : 0.5));
+            gTemperatureCount++;
+        } else if(strcmp(command, "press") == 0) {
+            launchpad_appendEvent(time, SIMEVENT_PRESS);
+        } else if(strcmp(command, "release") == 0) {
+            launchpad_appendEvent(time, SIMEVENT_RELEASE);
+        } else if(strcmp(command, "end") == 0) {
+            launchpad_appendEvent(time, SIMEVENT_END);
+        } else {
+            fprintf(stderr, "%s:%u: unknown command '%s'\n", path, lineNumber, command);
+            exit(1);
+        }
+    }
+    fclose(file);
+    if(gEventCount == 0 || gEvents[gEventCount - 1].type != SIMEVENT_END) {
+        launchpad_appendEvent(lastTime, SIMEVENT_END);
+    }
+}
+
+/**
+ * Appends an event to the script.
+ */
+static void launchpad_appendEvent(uint32_t time, SimEventType_t type) {
+    gEvents = realloc(gEvents, (gEventCount + 1) * sizeof(SimEvent_t));
+    if(gEvents == NULL) {
+        fprintf(stderr, "out of memory for the script\n");
+        exit(1);
+    }
+    gEvents[gEventCount].time = time;
+    gEvents[gEventCount].type = type;
+    gEventCount++;
+}
+
+/**
+ * Executes every event of the script, which occurs at the current virtual time.
+ */
+static void launchpad_runScript(void) {
+    uint32_t now = launchpad_getSystemTicks();
+    while(gNextEvent < gEventCount && gEvents[gNextEvent].time <= now) {
+        switch(gEvents[gNextEvent++].type) {
+        case SIMEVENT_PRESS:
+            printf("%lu BUTTON press\n", (unsigned long)now);
+            launchpad_setButtonPin(1);
+            break;
+        case SIMEVENT_RELEASE:
+            printf("%lu BUTTON release\n", (unsigned long)now);
+            launchpad_setButtonPin(0);
+            break;
+        case SIMEVENT_END:
+            launchpad_finish();
+            break;
+        }
+    }
+}
+
+/**
+ * Changes the level of the button pin, which is pulled to ground while the button is pressed. The interrupt flag is set on the edge
+ * selected by the interrupt edge select register, like the port module does.
+ */
+static void launchpad_setButtonPin(unsigned char pressed) {
+    unsigned char wasPressed = (BTN_STATE) == 0;
+    if(pressed) {
+        BTN_PORT_IN &= ~BTN_SHIFT;
+    } else {
+        BTN_PORT_IN |= BTN_SHIFT;
+    }
+    if(pressed != wasPressed && ((BTN_PORT_IES & BTN_SHIFT) != 0) == pressed) {
+        BTN_PORT_IFG |= BTN_SHIFT;
+    }
+}
+
+/**
+ * Executes the interrupt of port 1 if its flag and its enable bit are set.
+ */
+static unsigned char launchpad_servicePortInterrupt(void) {
+    if(P1IE & P1IFG) {
+        PORT1_ISR();
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Executes the switch interrupt if it is pending. Like on the launchpad, the switchCallback runs with global interrupts disabled and the interrupted
+ * thread continues with global interrupts enabled, when it is switched back.
+ */
+static void launchpad_serviceSwitchInterrupt(void) {
+    if(gSwitchRequested) {
+        gSwitchRequested = 0;
+        gInterruptState = 0;
+        switchCallback();
+        gInterruptState = GIE;
+    }
+}
+
+/**
+ * Records every LCD memory register and LED, which has changed since the last record. A line contains the system ticks, the name and the new value.
+ */
+static void launchpad_recordState(void) {
+    unsigned long now = launchpad_getSystemTicks();
+    uint8_t leds = 0;
+    unsigned int i;
+
+    if(memcmp(gRecordedLCD, (const void*)gLCDMemory, sizeof(gRecordedLCD)) != 0) {
+        printf("%lu LCD", now);
+        for(i = 1; i <= LCD_MEMORY_SIZE; i++) {
+            gRecordedLCD[i] = gLCDMemory[i];
+            printf(" %02X", gRecordedLCD[i]);
+        }
+        printf("\n");
+    }
+    if((LED_GREEN_DIR & LED_GREEN_SHIFT) && (LED_GREEN_OUT & LED_GREEN_SHIFT)) {
+        leds |= 1;
+    }
+    if((LED_RED_DIR & LED_RED_SHIFT) && (LED_RED_OUT & LED_RED_SHIFT)) {
+        leds |= 2;
+    }
+    if(leds != gRecordedLEDs) {
+        printf("%lu LED green %u red %u\n", now, leds & 1, (leds >> 1) & 1);
+        gRecordedLEDs = leds;
+    }
+}
+
+/**
+ * Records the final state, the time spent in each power mode and the number of samples and terminates the simulation.
+ */
+static void launchpad_finish(void) {
+    PowerStatistics_t statistics;
+    TemperatureSample_t sample;
+    uint16_t samples = launchpad_getTemperatureSample(&sample);
+
+    launchpad_recordState();
+    launchpad_getPowerStatistics(&statistics);
+    printf("%lu END samples %u active %lu lpm0 %lu lpm3 %lu\n", (unsigned long)launchpad_getSystemTicks(), samples,
+           (unsigned long)statistics.activeTime, (unsigned long)statistics.lpm0Time, (unsigned long)statistics.lpm3Time);
+    exit(0);
+}
+
+#endif /* LAUNCHPAD_SIMULATOR */
@@ -0,0 +1,113 @@
+/*
+ * msp430.h
+ *
+ *  This file replaces the device header of the MSP430FR6989 for the simulated launchpad. Every register used by the drivers is a variable
+ *  of the simulated register file, which is defined and evaluated by "launchpad.c" of the simulator. The intrinsic functions operate on the
+ *  simulated global interrupt enable flag. Only the registers and bits of the drivers that run unchanged in the simulator are declared.
+ *
+ */
+
+#ifndef SIM_MSP430_H_
+#define SIM_MSP430_H_
+
+#include <stdint.h>
+
+#define __interrupt                                                             //Interrupt service routines are normal functions called by the simulator
+
+#define BIT0                        0x0001
+#define BIT1                        0x0002
+#define BIT2                        0x0004
+#define BIT3                        0x0008
+#define BIT4                        0x0010
+#define BIT5                        0x0020
+#define BIT6                        0x0040
+#define BIT7                        0x0080
+
+#define GIE                         0x0008                                      //Global interrupt enable bit of the status register
+#define LPM0_bits                   0x0010
+#define LPM3_bits                   0x00D0
+
+extern volatile uint8_t P1IN;                                                   //Digital I/O port 1, the button and the red LED
+extern volatile uint8_t P1OUT;
+extern volatile uint8_t P1DIR;
+extern volatile uint8_t P1REN;
+extern volatile uint8_t P1SEL0;
+extern volatile uint8_t P1IE;
+extern volatile uint8_t P1IES;
+extern volatile uint8_t P1IFG;
+extern volatile uint8_t P9OUT;                                                  //Digital I/O port 9, the green LED
+extern volatile uint8_t P9DIR;
+
+extern volatile uint16_t TA0CCTL1;                                              //Capture/compare register 1 of TimerA0, which is used by the buttonDriver
+extern volatile uint16_t TA0CCR1;
+#define CCIE                        0x0010                                      //Capture/compare interrupt enable
+#define CCIFG                       0x0001                                      //Capture/compare interrupt flag
+
+#define LCD_MEMORY_SIZE             22                                          //Number of LCD memory registers LCDM1 to LCDM22
+extern volatile uint8_t gLCDMemory[LCD_MEMORY_SIZE + 1];                        //LCD memory, indexed by the number of the register. Index 0 is unused
+#define LCDM4                       gLCDMemory[4]
+#define LCDM5                       gLCDMemory[5]
+#define LCDM6                       gLCDMemory[6]
+#define LCDM8                       gLCDMemory[8]
+#define LCDM10                      gLCDMemory[10]
+#define LCDM11                      gLCDMemory[11]
+#define LCDM16                      gLCDMemory[16]
+#define LCDM19                      gLCDMemory[19]
+
+extern volatile uint16_t LCDCCTL0;                                              //LCD control registers, which are only recorded
+extern volatile uint16_t LCDCPCTL0;
+extern volatile uint16_t LCDCPCTL1;
+extern volatile uint16_t LCDCPCTL2;
+extern volatile uint16_t LCDCMEMCTL;
+#define LCDON                       0x0001
+#define LCDSON                      0x0004
+#define LCDMX0                      0x0008
+#define LCDMX1                      0x0010
+#define LCDDIV4                     0x1000
+#define LCDCLRM                     0x0002                                      //Clears the LCD memory, which is done by the simulator when the display is cleared
+#define LCDS6                       0x0040
+#define LCDS7                       0x0080
+#define LCDS8                       0x0100
+#define LCDS10                      0x0400
+#define LCDS11                      0x0800
+#define LCDS14                      0x4000
+#define LCDS15                      0x8000
+#define LCDS18                      0x0004
+#define LCDS19                      0x0008
+#define LCDS20                      0x0010
+#define LCDS28                      0x1000
+#define LCDS29                      0x2000
+#define LCDS30                      0x4000
+#define LCDS36                      0x0010
+#define LCDS37                      0x0020
+
+/**
+ * Returns the state of the simulated global interrupt enable flag.
+ */
+unsigned short _get_interrupt_state(void);
+
+/**
+ * Restores the simulated global interrupt enable flag.
+ */
+void _set_interrupt_state(unsigned short state);
+
+/**
+ * Disables the simulated global interrupts.
+ */
+void _disable_interrupts(void);
+
+/**
+ * Disables the simulated global interrupts.
+ */
+void __disable_interrupt(void);
+
+/**
+ * Enables the simulated global interrupts.
+ */
+void __enable_interrupt(void);
+
+#define __no_operation()
+#define __even_in_range(x, y)       (x)
+#define __bic_SR_register_on_exit(x)                                            //Interrupts of the simulator always return to the idle loop of the launchpad
+
+#endif /* SIM_MSP430_H_ */
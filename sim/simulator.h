@@ -0,0 +1,28 @@
+/*
+ * simulator.h
+ *
+ *  This file defines the interface between the parts of the simulated launchpad. The board itself, the virtual time and the script
+ *  are implemented in "launchpad.c", the simulated devices on the I2C bus in "i2cDriver.c" and the backchannel UART in "uartDriver.c".
+ *
+ *  The simulator is built for Linux with LAUNCHPAD_SIMULATOR defined and "sim" in front of the include path, so the drivers find the
+ *  simulated register file instead of the device header. Virtual time only advances while every thread waits, so a simulation is deterministic
+ *  and runs much faster than real time. A thread that never waits stops the virtual time.
+ *
+ */
+
+#ifndef SIM_SIMULATOR_H_
+#define SIM_SIMULATOR_H_
+
+#include <stdint.h>
+
+#define SIMULATOR_SCRIPT_VARIABLE       "LAUNCHPAD_SIM_SCRIPT"  //Defines the environment variable with the path of the script
+#define SIMULATOR_UART_VARIABLE         "LAUNCHPAD_SIM_UART"    //Defines the environment variable with the path of a file for the UART stream instead of a pseudo-terminal
+#define SIMULATOR_DEFAULT_DURATION      60000                   //Defines the system ticks simulated without a script
+#define SIMULATOR_DEFAULT_TEMPERATURE   2100                    //Defines the temperature in 1/100 degree Celsius until the script sets one
+
+/**
+ * Returns the temperature in 1/100 degree Celsius at the current virtual time, which is interpolated linearly between the points of the script.
+ */
+int32_t simulator_getTemperature(void);
+
+#endif /* SIM_SIMULATOR_H_ */
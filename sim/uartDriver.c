@@ -0,0 +1,102 @@
+/*
+ * uartDriver.c
+ *
+ *  This file implements uartDriver.h for the simulated launchpad. The bytes are written to a pseudo-terminal right away, whose name is printed to stderr,
+ *  so a host program like "tools/telemetryDecoder.c" reads the stream like from the backchannel of the launchpad. If SIMULATOR_UART_VARIABLE names
+ *  a file, the stream is written to it instead, which keeps every byte of a simulation running faster than real time.
+ *
+ */
+
+#if defined(LAUNCHPAD_SIMULATOR)
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE 600
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <termios.h>
+#include "uartDriver.h"
+#include "launchpad.h"
+#include "simulator.h"
+
+static int gFile = -1;                                          //Master of the pseudo-terminal or the file of the stream, -1 if the stream is discarded
+static int gTerminal = -1;                                      //Slave of the pseudo-terminal, which is kept open, so writes do not fail without a reader
+static uint32_t gBytesSent = 0;
+static uint16_t gPeakUsage = 0;
+
+/**
+ * Opens the file of SIMULATOR_UART_VARIABLE or a pseudo-terminal in raw mode, so the line discipline does not change any byte.
+ */
+void uartDriver_init(void) {
+    const char* path = getenv(SIMULATOR_UART_VARIABLE);
+    struct termios settings;
+
+    if(gFile >= 0) {
+        return;
+    }
+    if(path != NULL && *path != '\0') {
+        gFile = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(gFile < 0) {
+            fprintf(stderr, "cannot open the UART stream %s\n", path);
+        }
+        return;
+    }
+    gFile = posix_openpt(O_RDWR | O_NOCTTY);
+    if(gFile < 0 || grantpt(gFile) != 0 || unlockpt(gFile) != 0 || (gTerminal = open(ptsname(gFile), O_RDWR | O_NOCTTY)) < 0) {
+        fprintf(stderr, "cannot open a pseudo-terminal for the UART\n");
+        gFile = -1;
+        return;
+    }
+    tcgetattr(gTerminal, &settings);
+    cfmakeraw(&settings);
+    tcsetattr(gTerminal, TCSANOW, &settings);
+    fcntl(gFile, F_SETFL, O_NONBLOCK);                          //A full pseudo-terminal drops bytes like a full ring buffer
+    fprintf(stderr, "UART %s\n", ptsname(gFile));
+}
+
+/**
+ * The bytes are written right away, so the ring buffer is always empty.
+ */
+size_t uartDriver_getFree(void) {
+    return UART_BUFFER_SIZE;
+}
+
+/**
+ * Writes the bytes to the stream. Bytes, which do not fit into the pseudo-terminal, are lost. This is an atomic function.
+ */
+int uartDriver_write(const uint8_t* data, size_t length) {
+    unsigned short s;
+    if(length > UART_BUFFER_SIZE) {
+        return -1;
+    }
+    ATOMIC_START(s);
+    if(length > gPeakUsage) {
+        gPeakUsage = length;
+    }
+    while(gFile >= 0 && length > 0) {
+        ssize_t written = write(gFile, data, length);
+        if(written < 0 && errno == EINTR) {
+            continue;
+        }
+        if(written <= 0) {
+            break;
+        }
+        data += written;
+        length -= written;
+        gBytesSent += written;
+    }
+    ATOMIC_END(s);
+    return 0;
+}
+
+/**
+ * Copies the statistics of the stream.
+ */
+void uartDriver_getStatistics(UARTStatistics_t* statistics) {
+    statistics->bytesSent = gBytesSent;
+    statistics->peakUsage = gPeakUsage;
+}
+
+#endif /* LAUNCHPAD_SIMULATOR */
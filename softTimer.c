@@ -0,0 +1,129 @@
+/**
+ * softTimer.c
+ *
+ * This file contains the implementation of the functionality declared in softTimer.h.
+ *
+ */
+
+#include "scheduler.h"
+#include "softTimer.h"
+#include "port/port.h"
+
+static SoftTimer_t* gActiveTimers = NULL;               //List of active timers, sorted by their expiry
+static ThreadQueue_t gServiceQueue = {THREAD_ID_INVALID, THREAD_ID_INVALID, THREADQUEUE_FIFO};  //Queue of the timer service, while it waits for the next expiry
+
+/**
+ * Inserts a timer into the list of active timers behind every timer that expires earlier or at the same time.
+ */
+static void softTimer_insert(SoftTimer_t* timer);
+
+/**
+ * Removes a timer from the list of active timers.
+ */
+static void softTimer_remove(SoftTimer_t* timer);
+
+/**
+ * Initializes a timer, which is not active yet.
+ */
+void softTimer_init(SoftTimer_t* timer, SoftTimerCallback_t callback, void* argument) {
+    timer->callback = callback;
+    timer->argument = argument;
+    timer->period = 0;
+    timer->active = 0;
+    timer->next = NULL;
+}
+
+/**
+ * Starts a timer by inserting it into the list of active timers. If it expires before every other timer, the timer service is woken up,
+ * so it waits for the new expiry instead. This is an atomic function.
+ */
+void softTimer_start(SoftTimer_t* timer, uint16_t delay, uint16_t period) {
+    unsigned short s;
+    ATOMIC_START(s);
+    if(timer->active) {
+        softTimer_remove(timer);
+    }
+    timer->expiry = port_getSystemTicks() + delay;
+    timer->period = period;
+    timer->active = 1;
+    softTimer_insert(timer);
+    if(gActiveTimers == timer) {
+        scheduler_resumeQueuedThread(&gServiceQueue);
+    }
+    ATOMIC_END(s);
+}
+
+/**
+ * Stops a timer by removing it from the list of active timers. The timer service does not have to be woken up, an earlier wake-up only
+ * finds no expired timer. This is an atomic function.
+ */
+void softTimer_stop(SoftTimer_t* timer) {
+    unsigned short s;
+    ATOMIC_START(s);
+    if(timer->active) {
+        softTimer_remove(timer);
+        timer->active = 0;
+    }
+    ATOMIC_END(s);
+}
+
+/**
+ * Runs the timer service. The service takes every expired timer from the head of the list and executes its callback with interrupts enabled.
+ * An auto-reload timer is inserted again before, so the callback may stop it. Expiries that have been missed completely are skipped.
+ * Afterwards the service waits in its queue until the next expiry with a timeout, which is handled by the sleep queue of the scheduler,
+ * or until an earlier timer is started.
+ */
+void softTimer_runService(void) {
+    unsigned short s;
+    ATOMIC_START(s);
+    while(1) {
+        uint32_t now = port_getSystemTicks();
+        SoftTimer_t* timer = gActiveTimers;
+
+        if(timer != NULL && (int32_t)(timer->expiry - now) <= 0) {
+            gActiveTimers = timer->next;
+            if(timer->period != 0) {
+                timer->expiry += timer->period;
+                if((int32_t)(timer->expiry - now) <= 0) {
+                    timer->expiry = now + timer->period;
+                }
+                softTimer_insert(timer);
+            } else {
+                timer->active = 0;
+            }
+            ATOMIC_END(s);
+            timer->callback(timer->argument);
+            ATOMIC_START(s);
+        } else if(timer != NULL) {
+            int32_t delay = timer->expiry - now;
+            scheduler_blockThreadInQueueTimeout(&gServiceQueue, delay > 0xFFFF ? 0xFFFF : (uint16_t)delay);
+        } else {
+            scheduler_blockThreadInQueue(&gServiceQueue);
+        }
+    }
+}
+
+/**
+ * Inserts a timer into the sorted list of active timers. This is linear in the number of timers that expire earlier.
+ */
+static void softTimer_insert(SoftTimer_t* timer) {
+    SoftTimer_t** link = &gActiveTimers;
+    while(*link != NULL && (int32_t)((*link)->expiry - timer->expiry) <= 0) {
+        link = &(*link)->next;
+    }
+    timer->next = *link;
+    *link = timer;
+}
+
+/**
+ * Removes a timer from the list of active timers.
+ */
+static void softTimer_remove(SoftTimer_t* timer) {
+    SoftTimer_t** link = &gActiveTimers;
+    while(*link != NULL && *link != timer) {
+        link = &(*link)->next;
+    }
+    if(*link != NULL) {
+        *link = timer->next;
+    }
+}
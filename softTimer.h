@@ -0,0 +1,47 @@
+/**
+ * softTimer.h
+ *
+ * This Headerfile defines the basic structure and functions of software timers. The callbacks of all timers are executed one after another
+ * by a single timer service, so many periodic jobs share the stack of one thread.
+ *
+ */
+
+
+#ifndef SOFTTIMER_H_
+#define SOFTTIMER_H_
+
+#include "thread.h"
+
+typedef void (*SoftTimerCallback_t)(void* argument);   //Defines the function pointers to a function that is executed when a timer expires
+
+typedef struct SoftTimer {                              //Defines the control block of a software timer
+    SoftTimerCallback_t callback;
+    void* argument;                                     //Passed to the callback
+    uint32_t expiry;                                    //Absolute system tick at which the timer expires
+    uint16_t period;                                    //Ticks between two expiries of an auto-reload timer, 0 for a one-shot timer
+    unsigned char active;
+    struct SoftTimer* next;                             //Links the timer to the next one in the list of active timers
+} SoftTimer_t;
+
+/**
+ * Initializer function for a software timer, which executes the callback with the argument when it expires.
+ */
+void softTimer_init(SoftTimer_t* timer, SoftTimerCallback_t callback, void* argument);
+
+/**
+ * Starts a timer, which expires after the delay in milliseconds (approx). With a period other than 0, the timer is started again every period milliseconds.
+ * A timer that is already active is restarted.
+ */
+void softTimer_start(SoftTimer_t* timer, uint16_t delay, uint16_t period);
+
+/**
+ * Stops a timer, so its callback is not executed anymore.
+ */
+void softTimer_stop(SoftTimer_t* timer);
+
+/**
+ * Runs the timer service in the calling thread, which executes the callbacks of the expired timers. This function does not return.
+ */
+void softTimer_runService(void);
+
+#endif /* SOFTTIMER_H_ */
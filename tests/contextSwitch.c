@@ -0,0 +1,105 @@
+/**
+ * contextSwitch.c
+ *
+ * This host test checks the context switch of the port and compares its cost with the setjmp/longjmp switch it replaced. A second context
+ * is switched with the main context without the scheduler, first with port_switchContext and afterwards with _setjmp/_longjmp, which is
+ * how the scheduler switched before. On Linux port_switchContext is swapcontext, which also saves the signal mask with a system call,
+ * so the comparison only shows the overhead of the host. The cycle counts of the MSP430 are measured by the kernel benchmark on the board.
+ *
+ * gcc -O2 -I. port/linux/port.c tests/contextSwitch.c -o contextSwitch
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#undef _FORTIFY_SOURCE                                  //The checked longjmp of the C library does not allow to jump to a different stack
+#include <assert.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include "port/port.h"
+
+#define CONTEXTSWITCH_SWITCHES  100000                  //Number of round trips of every measurement
+#define CONTEXTSWITCH_STACK_SIZE 65536                  //Stack size of the second context
+
+typedef enum {                                          //Defines how the second context switches back
+    CONTEXTSWITCH_PHASE_PORT,
+    CONTEXTSWITCH_PHASE_SETJMP
+} ContextSwitchPhase_t;
+
+static uint8_t gStack[CONTEXTSWITCH_STACK_SIZE] __attribute__((aligned(PORT_STACK_ALIGNMENT)));
+static PortContext_t gMainContext = NULL;
+static PortContext_t gSecondContext = NULL;
+static jmp_buf gMainJump;
+static jmp_buf gSecondJump;
+static volatile ContextSwitchPhase_t gPhase = CONTEXTSWITCH_PHASE_PORT;
+static volatile unsigned long gResumes = 0;             //Number of times the second context has been continued
+
+/**
+ * The kernel is not linked and the timer is never programmed, so the callbacks of the port do nothing.
+ */
+void timerCallback(uint16_t time) {
+    (void)time;
+}
+
+void switchCallback(void) {
+}
+
+/**
+ * Entry of the second context. It counts every time it is continued and switches back right away, until it changes to the setjmp/longjmp phase.
+ * The local variable checks that the context keeps its own registers and stack across the switches. This function never returns.
+ */
+static void contextSwitch_entry(void) {
+    unsigned long resumes = 0;
+
+    while(gPhase == CONTEXTSWITCH_PHASE_PORT) {
+        resumes++;
+        gResumes++;
+        assert(resumes == gResumes);
+        port_switchContext(&gSecondContext, gMainContext);
+    }
+    if(_setjmp(gSecondJump) == 0) {
+        port_switchContext(&gSecondContext, gMainContext);
+    }
+    while(1) {
+        if(_setjmp(gSecondJump) == 0) {
+            _longjmp(gMainJump, 1);
+        }
+    }
+}
+
+/**
+ * Switches to the second context and back CONTEXTSWITCH_SWITCHES times with each method and prints the cost of a single switch.
+ */
+int main(void) {
+    unsigned long i;
+    unsigned long sum = 0;
+    PortCycles_t start;
+    double portCost;
+    double setjmpCost;
+
+    port_initContext(&gSecondContext, gStack, sizeof(gStack), &contextSwitch_entry);
+    start = port_getCycles();
+    for(i = 0; i < CONTEXTSWITCH_SWITCHES; i++) {
+        port_switchContext(&gMainContext, gSecondContext);
+        sum += i;
+        assert(gResumes == i + 1);                      //The second context has run exactly once
+    }
+    portCost = (double)(PortCycles_t)(port_getCycles() - start) / (2.0 * CONTEXTSWITCH_SWITCHES);
+    assert(sum == (unsigned long)CONTEXTSWITCH_SWITCHES * (CONTEXTSWITCH_SWITCHES - 1) / 2);
+
+    gPhase = CONTEXTSWITCH_PHASE_SETJMP;
+    port_switchContext(&gMainContext, gSecondContext);
+    start = port_getCycles();
+    for(i = 0; i < CONTEXTSWITCH_SWITCHES; i++) {
+        if(_setjmp(gMainJump) == 0) {
+            _longjmp(gSecondJump, 1);
+        }
+    }
+    setjmpCost = (double)(PortCycles_t)(port_getCycles() - start) / (2.0 * CONTEXTSWITCH_SWITCHES);
+
+    printf("{\"name\":\"portSwitch\",\"cyclesPerSwitch\":%.1f,\"frequency\":%lu}\n", portCost, PORT_CYCLE_FREQUENCY);
+    printf("{\"name\":\"setjmpSwitch\",\"cyclesPerSwitch\":%.1f,\"frequency\":%lu}\n", setjmpCost, PORT_CYCLE_FREQUENCY);
+    return 0;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,84 @@
+/**
+ * displayWrites.c
+ *
+ * This host test runs the displayDriver against a fake LCD register file and counts the LCD memory registers written per update. Before every
+ * update the registers are filled with a value that no frame contains, so every register that holds another value afterwards has been written.
+ * The frame shown after an update is compared with the frame of a cleared display, which is written completely.
+ *
+ * gcc -O2 -DLAUNCHPAD_SIMULATOR -Isim -Idrivers -I. drivers/displayDriver.c drivers/temperatureConverter.c tests/displayWrites.c -o displayWrites
+ *
+ */
+
+#if defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "displayDriver.h"
+
+#define DISPLAYWRITES_UNWRITTEN     0xAA                                        //Value of no symbol, which marks a register that has not been written
+
+volatile uint8_t gLCDMemory[LCD_MEMORY_SIZE + 1];                               //Fake LCD register file
+volatile uint16_t LCDCCTL0;
+volatile uint16_t LCDCPCTL0;
+volatile uint16_t LCDCPCTL1;
+volatile uint16_t LCDCPCTL2;
+volatile uint16_t LCDCMEMCTL;
+
+static uint8_t gShown[LCD_MEMORY_SIZE + 1];                                     //LCD memory as shown by the display
+static unsigned long gWrites;                                                   //Registers written by all updates
+
+/**
+ * Clears the display like the LCD module, which clears its memory when LCDCLRM is set.
+ */
+static void displayWrites_clear(void) {
+    displayDriver_clear();
+    assert(LCDCMEMCTL & LCDCLRM);
+    LCDCMEMCTL &= ~LCDCLRM;
+    memset((void*)gLCDMemory, 0, sizeof(gLCDMemory));
+}
+
+/**
+ * Shows a temperature, checks the number of registers written and that the display shows the same frame as a cleared display would.
+ */
+static void displayWrites_show(Temperature_t temperature, TemperatureUnit_t unit, unsigned int expectedWrites) {
+    uint8_t expected[LCD_MEMORY_SIZE + 1];
+    unsigned int writes = 0;
+    unsigned int i;
+
+    memset((void*)gLCDMemory, DISPLAYWRITES_UNWRITTEN, sizeof(gLCDMemory));
+    displayDriver_showTemperature(temperature, unit);
+    for(i = 1; i <= LCD_MEMORY_SIZE; i++) {
+        if(gLCDMemory[i] != DISPLAYWRITES_UNWRITTEN) {
+            gShown[i] = gLCDMemory[i];
+            writes++;
+        }
+    }
+    printf("{\"name\":\"displayWrites\",\"temperature\":%d,\"unit\":%d,\"writes\":%u}\n", temperature, unit, writes);
+    assert(writes == expectedWrites);
+    gWrites += writes;
+
+    displayWrites_clear();                                                      //The full frame of a cleared display is the reference
+    displayDriver_showTemperature(temperature, unit);
+    memcpy(expected, (const void*)gLCDMemory, sizeof(expected));
+    assert(memcmp(expected + 1, gShown + 1, LCD_MEMORY_SIZE) == 0);
+}
+
+int main(void) {
+    displayDriver_init();
+    displayWrites_clear();
+    memset(gShown, 0, sizeof(gShown));
+
+    displayWrites_show(201, CELSIUS, 6);                                        //Three digits, the decimal point, the degree and the unit
+    displayWrites_show(201, CELSIUS, 0);                                        //An unchanged temperature does not write the LCD at all
+    displayWrites_show(202, CELSIUS, 1);                                        //Only the last digit changes
+    displayWrites_show(219, CELSIUS, 2);
+    displayWrites_show(219, FAHRENHEIT, 1);                                     //Only the unit changes
+    displayWrites_show(-219, FAHRENHEIT, 1);                                    //Only the sign appears
+    displayWrites_show(-9, FAHRENHEIT, 2);                                      //The two leading digits are switched off
+    displayWrites_show(1234, FAHRENHEIT, 5);                                    //The sign is switched off and three digits change
+    printf("{\"name\":\"displayWritesTotal\",\"updates\":8,\"writes\":%lu,\"fullWrites\":%u}\n", gWrites, 8 * 8);
+    return 0;
+}
+
+#endif /* LAUNCHPAD_SIMULATOR */
@@ -0,0 +1,266 @@
+/**
+ * i2cTransfer.c
+ *
+ * This host test runs the i2cDriver against a model of the I2C module USCI_B0 and of one device on the bus. The model executes the interrupt
+ * of the driver for every event of the bus and decides at the acknowledge of every received byte, whether the master ends the read there,
+ * just like the module: with a stop condition requested while the byte is being received or with the byte counter. It checks that the device
+ * sends exactly the requested bytes of a read, also of a single byte read on its own and after a repeated start condition, that a write
+ * is not ended by the byte counter of a previous read and that the byte counter is only configured while the module is in software reset.
+ * The driver is included with a fake device header and fake launchpad functions.
+ *
+ * gcc -O2 -Isim -I. scheduler.c semaphor.c mutex.c trace.c port/linux/port.c tests/i2cTransfer.c -o i2cTransfer
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "scheduler.h"
+
+#define SIM_MSP430_H_                                   //Replaces <msp430.h> and "launchpad.h" of the drivers with the fakes below
+#define LAUNCHPAD_H_
+
+#define BIT6                        0x0040
+#define BIT7                        0x0080
+#define LPM3_bits                   0x00D0
+
+#define UCSWRST                     0x0001              //UCB0CTLW0
+#define UCTXSTT                     0x0002
+#define UCTXSTP                     0x0004
+#define UCTR                        0x0010
+#define UCSSEL_2                    0x0080
+#define UCSYNC                      0x0100
+#define UCMODE_3                    0x0600
+#define UCMST                       0x0800
+#define UCASTP_2                    0x0008              //UCB0CTLW1
+#define UCASTP_3                    0x000C
+#define UCRXIE0                     0x0001              //UCB0IE
+#define UCTXIE0                     0x0002
+#define UCSTPIE                     0x0008
+#define UCALIE                      0x0010
+#define UCNACKIE                    0x0020
+
+#define USCI_I2C_UCALIFG            0x0002              //UCB0IV
+#define USCI_I2C_UCNACKIFG          0x0004
+#define USCI_I2C_UCSTPIFG           0x0008
+#define USCI_I2C_UCRXIFG0           0x0016
+#define USCI_I2C_UCTXIFG0           0x0018
+#define USCI_I2C_UCBIT9IFG          0x001E
+
+#define __interrupt
+#define __even_in_range(value, range)   (value)
+#define __bic_SR_register_on_exit(bits)
+
+#define UCB0CTLW0                   (*i2cTransfer_control())
+
+static volatile uint16_t* i2cTransfer_control(void);
+static volatile uint16_t UCB0CTLW1;
+static volatile uint16_t UCB0TBCNT;
+static volatile uint16_t P1SEL0;
+static volatile uint16_t UCB0BRW;
+static volatile uint16_t UCB0IE;
+static volatile uint16_t UCB0IV;
+static volatile uint16_t UCB0I2CSA;
+static volatile uint16_t UCB0RXBUF;
+static volatile uint16_t UCB0TXBUF;
+
+void launchpad_requestSMCLK(void) {
+}
+
+void launchpad_releaseSMCLK(void) {
+}
+
+#include "../drivers/i2cDriver.c"
+
+#define I2CTRANSFER_ADDRESS         0x40                //Address of the device
+#define I2CTRANSFER_NOTHING         0x100               //Value of UCB0TXBUF until the driver writes a byte
+#define I2CTRANSFER_MAX_STEPS       1000                //Events of the bus after which a transaction is considered stuck
+
+typedef enum {                                          //Defines the phase of the bus
+    I2CTRANSFER_IDLE,
+    I2CTRANSFER_WRITING,
+    I2CTRANSFER_READING,
+    I2CTRANSFER_NACKED                                  //The device did not acknowledge its address, the master has to send the stop
+} I2CTransferPhase_t;
+
+static volatile uint16_t gControl;
+static I2CTransferPhase_t gPhase = I2CTRANSFER_IDLE;
+static int gAddressSent = 0;                            //Set when the address has been sent, until the model handled it
+static int gInReset = 0;                                //Set while the module is in software reset
+static uint16_t gConfiguration;                         //UCB0CTLW1 and UCB0TBCNT when the module left software reset
+static uint16_t gThreshold;
+static unsigned int gCount;                             //Bytes since the last start condition, which is the byte counter of the module
+static uint8_t gWritten[16];                            //Bytes the device received
+static unsigned int gWrittenCount;
+static unsigned int gReadCount;                         //Bytes the device sent
+static unsigned int gStops;
+
+/**
+ * Takes over the configuration when the module leaves software reset. The module ignores changes made to it while it is running.
+ */
+static void i2cTransfer_latch(void) {
+    if(gControl & UCSWRST) {
+        gInReset = 1;
+    } else if(gInReset) {
+        gInReset = 0;
+        gConfiguration = UCB0CTLW1;
+        gThreshold = UCB0TBCNT;
+    }
+}
+
+/**
+ * Sends the address of a pending start condition. The module clears UCTXSTT when the device acknowledged the address.
+ * The configuration must not have been changed since the module left software reset.
+ */
+static void i2cTransfer_sendAddress(void) {
+    i2cTransfer_latch();
+    assert(UCB0CTLW1 == gConfiguration && UCB0TBCNT == gThreshold);
+    gControl &= ~UCTXSTT;
+    gCount = 0;
+    gAddressSent = 1;
+}
+
+/**
+ * Returns UCB0CTLW0. The address of a start condition is sent before the next access, so a driver polling UCTXSTT sees it cleared.
+ */
+static volatile uint16_t* i2cTransfer_control(void) {
+    i2cTransfer_latch();
+    if((gControl & UCTXSTT) && !(gControl & UCSWRST)) {
+        i2cTransfer_sendAddress();
+    }
+    return &gControl;
+}
+
+/**
+ * Executes the interrupt of the driver for the specified event.
+ */
+static void i2cTransfer_interrupt(uint16_t vector) {
+    UCB0IV = vector;
+    USCI_B0_ISR();
+}
+
+/**
+ * Sends the stop condition, which ends the transaction.
+ */
+static void i2cTransfer_stop(void) {
+    gControl &= ~UCTXSTP;
+    gPhase = I2CTRANSFER_IDLE;
+    gStops++;
+    i2cTransfer_interrupt(USCI_I2C_UCSTPIFG);
+}
+
+/**
+ * Returns if the byte counter ends the current byte.
+ */
+static int i2cTransfer_counted(void) {
+    return (gConfiguration & UCASTP_3) == UCASTP_2 && gCount == gThreshold;
+}
+
+/**
+ * Runs the bus until it is idle. The device acknowledges only its own address and sends the numbers 1, 2, 3... when it is read.
+ * A stop condition requested while a byte is received ends the read with that byte.
+ */
+static void i2cTransfer_runBus(void) {
+    unsigned int steps;
+    for(steps = 0; steps < I2CTRANSFER_MAX_STEPS; steps++) {
+        if((gControl & UCTXSTT) && !(gControl & UCSWRST)) {
+            i2cTransfer_sendAddress();
+        }
+        if(gAddressSent) {
+            gAddressSent = 0;
+            if(UCB0I2CSA != I2CTRANSFER_ADDRESS) {
+                gPhase = I2CTRANSFER_NACKED;
+                i2cTransfer_interrupt(USCI_I2C_UCNACKIFG);
+            } else if(gControl & UCTR) {
+                gPhase = I2CTRANSFER_WRITING;
+                UCB0TXBUF = I2CTRANSFER_NOTHING;
+                i2cTransfer_interrupt(USCI_I2C_UCTXIFG0);
+            } else {
+                gPhase = I2CTRANSFER_READING;
+            }
+        } else if(gPhase == I2CTRANSFER_WRITING && UCB0TXBUF != I2CTRANSFER_NOTHING) {
+            assert(gWrittenCount < sizeof(gWritten));
+            gWritten[gWrittenCount++] = (uint8_t)UCB0TXBUF;
+            gCount++;
+            if(i2cTransfer_counted()) {
+                i2cTransfer_stop();
+                continue;
+            }
+            UCB0TXBUF = I2CTRANSFER_NOTHING;
+            i2cTransfer_interrupt(USCI_I2C_UCTXIFG0);
+        } else if(gPhase == I2CTRANSFER_READING) {
+            int last;
+            UCB0RXBUF = ++gReadCount;
+            gCount++;
+            last = (gControl & UCTXSTP) || i2cTransfer_counted();        //Decided at the acknowledge, before the interrupt of the byte
+            i2cTransfer_interrupt(USCI_I2C_UCRXIFG0);
+            if(last) {
+                i2cTransfer_stop();
+            }
+        } else if(gControl & UCTXSTP) {
+            i2cTransfer_stop();
+        } else if(gPhase == I2CTRANSFER_IDLE && !(gControl & UCTXSTT)) {
+            return;
+        }
+    }
+    assert(0);
+}
+
+/**
+ * Runs a transaction and returns its status. The bytes the device received and sent are counted from the start of the transaction.
+ */
+static I2CStatus_t i2cTransfer_run(uint8_t address, const uint8_t* txBuf, size_t txLen, uint8_t* rxBuf, size_t rxLen) {
+    I2CTransfer_t transfer = { .address = address, .txBuf = txBuf, .txLen = txLen, .rxBuf = rxBuf, .rxLen = rxLen };
+    gWrittenCount = 0;
+    gReadCount = 0;
+    gStops = 0;
+    i2cDriver_submit(&transfer);
+    i2cTransfer_runBus();
+    assert(gStops == 1);
+    assert(transfer.status != I2C_PENDING);
+    return transfer.status;
+}
+
+/**
+ * Reads the bytes and checks that the device sent exactly these bytes.
+ */
+static void i2cTransfer_checkRead(const uint8_t* txBuf, size_t txLen, size_t rxLen) {
+    uint8_t rxBuf[8];
+    size_t i;
+    memset(rxBuf, 0, sizeof(rxBuf));
+    assert(i2cTransfer_run(I2CTRANSFER_ADDRESS, txBuf, txLen, rxBuf, rxLen) == I2C_OK);
+    printf("{\"name\":\"read\",\"written\":%u,\"requested\":%u,\"sent\":%u}\n", (unsigned int)txLen, (unsigned int)rxLen, gReadCount);
+    assert(gWrittenCount == txLen);
+    assert(gReadCount == rxLen);
+    for(i = 0; i < rxLen; i++) {
+        assert(rxBuf[i] == i + 1);
+    }
+}
+
+int main(void) {
+    static const uint8_t command[3] = {0xF3, 0x12, 0x34};
+    uint8_t rxBuf[2];
+
+    scheduler_init();
+    i2cDriver_init();
+
+    i2cTransfer_checkRead(NULL, 0, 3);
+    i2cTransfer_checkRead(NULL, 0, 1);                  //The byte counter ends a single byte read
+    i2cTransfer_checkRead(NULL, 0, 2);
+    i2cTransfer_checkRead(command, 1, 1);               //A single byte after a repeated start condition
+    i2cTransfer_checkRead(command, 2, 2);
+
+    assert(i2cTransfer_run(I2CTRANSFER_ADDRESS, command, 3, NULL, 0) == I2C_OK);  //The counter of the single byte read before must not end the write
+    assert(gWrittenCount == 3 && memcmp(gWritten, command, 3) == 0);
+
+    assert(i2cTransfer_run(I2CTRANSFER_ADDRESS + 1, NULL, 0, rxBuf, 1) == I2C_ERROR_NACK);
+    assert(gReadCount == 0);
+    assert(i2cTransfer_run(I2CTRANSFER_ADDRESS + 1, command, 1, NULL, 0) == I2C_ERROR_NACK);
+    assert(gWrittenCount == 0);
+    i2cTransfer_checkRead(NULL, 0, 1);                  //The bus works again after a NACK
+    return 0;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,150 @@
+/**
+ * messageQueueThroughput.c
+ *
+ * This host test runs a producer and a consumer thread of the same priority over message queues of different capacities. It checks that every
+ * message arrives once and in order, by value and as pointer, and that a larger queue lets both threads work in batches instead of switching
+ * for every message.
+ *
+ * gcc -O2 -I. scheduler.c semaphor.c mutex.c messageQueue.c trace.c port/linux/port.c tests/messageQueueThroughput.c -o messageQueueThroughput
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include "scheduler.h"
+#include "semaphor.h"
+#include "messageQueue.h"
+
+#define MESSAGEQUEUETHROUGHPUT_MESSAGES     200000      //Number of messages of a measurement
+#define MESSAGEQUEUETHROUGHPUT_MAX_CAPACITY 64
+#define MESSAGEQUEUETHROUGHPUT_BUFFERS      4           //Number of buffers passed as pointer, one more than the capacity of the pointer queue
+#define MESSAGEQUEUETHROUGHPUT_BUFFER_SIZE  256
+#define MESSAGEQUEUETHROUGHPUT_STACK_SIZE   16384
+
+typedef struct {                                        //Message passed by value
+    uint32_t sequence;
+    uint32_t value;
+} Message_t;
+
+static MessageQueue_t gQueue;
+static Message_t gStorage[MESSAGEQUEUETHROUGHPUT_MAX_CAPACITY];
+static MessageQueue_t gPointerQueue;
+static void* gPointerStorage[MESSAGEQUEUETHROUGHPUT_BUFFERS - 1];
+static MessageQueue_t gFreeQueue;                       //Returns the buffers to the producer
+static void* gFreeStorage[MESSAGEQUEUETHROUGHPUT_BUFFERS];
+static uint32_t gBuffers[MESSAGEQUEUETHROUGHPUT_BUFFERS][MESSAGEQUEUETHROUGHPUT_BUFFER_SIZE / sizeof(uint32_t)];
+static Semaphor_t gDone;
+static volatile unsigned long gErrors;
+
+/**
+ * Returns the nanoseconds of the monotonic clock.
+ */
+static uint64_t messageQueueThroughput_getTime(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void messageQueueThroughput_producer(void) {
+    Message_t message;
+    uint32_t i;
+    for(i = 0; i < MESSAGEQUEUETHROUGHPUT_MESSAGES; i++) {
+        message.sequence = i;
+        message.value = i * 2654435761UL;
+        messageQueue_send(&gQueue, &message);
+    }
+    semaphor_V(&gDone);
+}
+
+static void messageQueueThroughput_consumer(void) {
+    Message_t message;
+    uint32_t i;
+    for(i = 0; i < MESSAGEQUEUETHROUGHPUT_MESSAGES; i++) {
+        messageQueue_receive(&gQueue, &message);
+        if(message.sequence != i || message.value != (uint32_t)(i * 2654435761UL)) {
+            gErrors++;
+        }
+    }
+    semaphor_V(&gDone);
+}
+
+/**
+ * Fills the buffers, which it takes from the free queue, and passes them on without copying.
+ */
+static void messageQueueThroughput_pointerProducer(void) {
+    uint32_t i;
+    for(i = 0; i < MESSAGEQUEUETHROUGHPUT_MESSAGES; i++) {
+        uint32_t* buffer = messageQueue_receivePointer(&gFreeQueue);
+        unsigned int j;
+        for(j = 0; j < MESSAGEQUEUETHROUGHPUT_BUFFER_SIZE / sizeof(uint32_t); j++) {
+            buffer[j] = i + j;
+        }
+        messageQueue_sendPointer(&gPointerQueue, buffer);
+    }
+    semaphor_V(&gDone);
+}
+
+static void messageQueueThroughput_pointerConsumer(void) {
+    uint32_t i;
+    for(i = 0; i < MESSAGEQUEUETHROUGHPUT_MESSAGES; i++) {
+        uint32_t* buffer = messageQueue_receivePointer(&gPointerQueue);
+        unsigned int j;
+        for(j = 0; j < MESSAGEQUEUETHROUGHPUT_BUFFER_SIZE / sizeof(uint32_t); j++) {
+            if(buffer[j] != i + j) {
+                gErrors++;
+            }
+        }
+        messageQueue_sendPointer(&gFreeQueue, buffer);
+    }
+    semaphor_V(&gDone);
+}
+
+/**
+ * Starts the producer and the consumer and returns the messages per second.
+ */
+static double messageQueueThroughput_run(void (*producer)(void), void (*consumer)(void)) {
+    uint64_t start = messageQueueThroughput_getTime();
+    assert(scheduler_startThread(consumer, THREAD_PRIORITY_NORMAL, MESSAGEQUEUETHROUGHPUT_STACK_SIZE) != THREAD_ID_INVALID);
+    assert(scheduler_startThread(producer, THREAD_PRIORITY_NORMAL, MESSAGEQUEUETHROUGHPUT_STACK_SIZE) != THREAD_ID_INVALID);
+    semaphor_P(&gDone);
+    semaphor_P(&gDone);
+    return MESSAGEQUEUETHROUGHPUT_MESSAGES * 1e9 / (double)(messageQueueThroughput_getTime() - start);
+}
+
+int main(void) {
+    static const unsigned int capacities[] = {1, 4, 16, MESSAGEQUEUETHROUGHPUT_MAX_CAPACITY};
+    double throughput[sizeof(capacities) / sizeof(capacities[0])];
+    double pointerThroughput;
+    unsigned int i;
+
+    scheduler_init();
+    port_enableInterrupts();
+    semaphor_init(&gDone);
+    scheduler_setPriority(scheduler_getRunningThread(), THREAD_PRIORITY_HIGHEST);
+
+    for(i = 0; i < sizeof(capacities) / sizeof(capacities[0]); i++) {
+        messageQueue_init(&gQueue, gStorage, sizeof(Message_t), capacities[i]);
+        throughput[i] = messageQueueThroughput_run(&messageQueueThroughput_producer, &messageQueueThroughput_consumer);
+        printf("{\"name\":\"byValue\",\"capacity\":%u,\"messagesPerSecond\":%.0f}\n", capacities[i], throughput[i]);
+        assert(gErrors == 0);
+        assert(gQueue.count == 0);
+    }
+    assert(throughput[3] > 2 * throughput[0]);          //Batches save a switch for most messages
+
+    messageQueue_init(&gPointerQueue, gPointerStorage, sizeof(void*), MESSAGEQUEUETHROUGHPUT_BUFFERS - 1);
+    messageQueue_init(&gFreeQueue, gFreeStorage, sizeof(void*), MESSAGEQUEUETHROUGHPUT_BUFFERS);
+    for(i = 0; i < MESSAGEQUEUETHROUGHPUT_BUFFERS; i++) {
+        messageQueue_sendPointer(&gFreeQueue, gBuffers[i]);
+    }
+    pointerThroughput = messageQueueThroughput_run(&messageQueueThroughput_pointerProducer, &messageQueueThroughput_pointerConsumer);
+    printf("{\"name\":\"byPointer\",\"bufferSize\":%u,\"buffers\":%u,\"messagesPerSecond\":%.0f}\n",
+           MESSAGEQUEUETHROUGHPUT_BUFFER_SIZE, MESSAGEQUEUETHROUGHPUT_BUFFERS, pointerThroughput);
+    assert(gErrors == 0);
+    assert(gPointerQueue.count == 0 && gFreeQueue.count == MESSAGEQUEUETHROUGHPUT_BUFFERS);
+    return 0;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,183 @@
+/**
+ * mutexLatency.c
+ *
+ * This host test compares the uncontended mutex_lock/mutex_unlock with a semaphor_P/semaphor_V pair and checks that priority inheritance bounds
+ * the priority inversion. A low priority thread holds the lock for MUTEXLATENCY_CRITICAL_SECTION ticks, while a high priority thread waits for it
+ * and a medium priority thread keeps the CPU busy for MUTEXLATENCY_BUSY_TIME ticks. With a mutex the high priority thread waits for the critical
+ * section only, with a semaphor as lock it also waits for the medium priority thread.
+ *
+ * gcc -O2 -I. scheduler.c semaphor.c mutex.c trace.c port/linux/port.c tests/mutexLatency.c -o mutexLatency
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include "scheduler.h"
+#include "semaphor.h"
+#include "mutex.h"
+
+#define MUTEXLATENCY_PAIRS              1000000         //Number of lock/unlock pairs of the fast path measurement
+#define MUTEXLATENCY_RUNS               5               //Number of fast path measurements, the fastest one is used
+#define MUTEXLATENCY_CRITICAL_SECTION   30              //Ticks the low priority thread holds the lock
+#define MUTEXLATENCY_BUSY_TIME          300             //Ticks the medium priority thread keeps the CPU busy
+#define MUTEXLATENCY_STACK_SIZE         16384
+
+static Mutex_t gMutex;
+static Semaphor_t gLock;                                //Semaphor used as lock, which is initialized with one release
+static Semaphor_t gDone;                                //Released by every thread when it terminates
+static unsigned char gUseMutex;                         //Selects the lock of the inversion test
+static volatile uint32_t gLatency;                      //Ticks the high priority thread waited for the lock
+
+/**
+ * Returns the nanoseconds of the monotonic clock.
+ */
+static uint64_t mutexLatency_getTime(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Keeps the CPU busy for the specified system ticks.
+ */
+static void mutexLatency_busy(uint32_t ticks) {
+    uint32_t start = port_getSystemTicks();
+    while(port_getSystemTicks() - start < ticks);
+}
+
+/**
+ * Takes the selected lock.
+ */
+static void mutexLatency_lock(void) {
+    if(gUseMutex) {
+        mutex_lock(&gMutex);
+    } else {
+        semaphor_P(&gLock);
+    }
+}
+
+/**
+ * Releases the selected lock.
+ */
+static void mutexLatency_unlock(void) {
+    if(gUseMutex) {
+        mutex_unlock(&gMutex);
+    } else {
+        semaphor_V(&gLock);
+    }
+}
+
+/**
+ * Takes the lock right away, while the other threads sleep, and holds it for the critical section.
+ */
+static void mutexLatency_lowThread(void) {
+    mutexLatency_lock();
+    mutexLatency_busy(MUTEXLATENCY_CRITICAL_SECTION);
+    mutexLatency_unlock();
+    semaphor_V(&gDone);
+}
+
+/**
+ * Starts to keep the CPU busy after the high priority thread waits for the lock.
+ */
+static void mutexLatency_mediumThread(void) {
+    scheduler_threadSleep(10);
+    mutexLatency_busy(MUTEXLATENCY_BUSY_TIME);
+    semaphor_V(&gDone);
+}
+
+/**
+ * Waits for the lock once the low priority thread holds it and measures how long it takes.
+ */
+static void mutexLatency_highThread(void) {
+    uint32_t start;
+    scheduler_threadSleep(5);
+    start = port_getSystemTicks();
+    mutexLatency_lock();
+    gLatency = port_getSystemTicks() - start;
+    mutexLatency_unlock();
+    semaphor_V(&gDone);
+}
+
+/**
+ * Runs the inversion scenario with the selected lock and returns the latency of the high priority thread. The main thread has the highest priority,
+ * so the threads start when it waits for them.
+ */
+static uint32_t mutexLatency_measureInversion(unsigned char useMutex) {
+    unsigned int i;
+    gUseMutex = useMutex;
+    mutex_init(&gMutex);
+    semaphor_init(&gLock);
+    semaphor_V(&gLock);
+    assert(scheduler_startThread(&mutexLatency_lowThread, THREAD_PRIORITY_LOW, MUTEXLATENCY_STACK_SIZE) != THREAD_ID_INVALID);
+    assert(scheduler_startThread(&mutexLatency_mediumThread, THREAD_PRIORITY_NORMAL, MUTEXLATENCY_STACK_SIZE) != THREAD_ID_INVALID);
+    assert(scheduler_startThread(&mutexLatency_highThread, THREAD_PRIORITY_HIGH, MUTEXLATENCY_STACK_SIZE) != THREAD_ID_INVALID);
+    for(i = 0; i < 3; i++) {
+        semaphor_P(&gDone);
+    }
+    return gLatency;
+}
+
+/**
+ * Returns the nanoseconds of an uncontended lock/unlock pair of the selected lock.
+ */
+static double mutexLatency_measurePair(unsigned char useMutex) {
+    double best = 0;
+    unsigned int run;
+    unsigned long i;
+
+    gUseMutex = useMutex;
+    mutex_init(&gMutex);
+    semaphor_init(&gLock);
+    semaphor_V(&gLock);
+    for(run = 0; run < MUTEXLATENCY_RUNS; run++) {
+        uint64_t start = mutexLatency_getTime();
+        double cost;
+        if(useMutex) {
+            for(i = 0; i < MUTEXLATENCY_PAIRS; i++) {
+                mutex_lock(&gMutex);
+                mutex_unlock(&gMutex);
+            }
+        } else {
+            for(i = 0; i < MUTEXLATENCY_PAIRS; i++) {
+                semaphor_P(&gLock);
+                semaphor_V(&gLock);
+            }
+        }
+        cost = (double)(mutexLatency_getTime() - start) / MUTEXLATENCY_PAIRS;
+        if(run == 0 || cost < best) {
+            best = cost;
+        }
+    }
+    return best;
+}
+
+int main(void) {
+    double mutexPair;
+    double semaphorPair;
+    uint32_t mutexLatency;
+    uint32_t semaphorLatency;
+
+    scheduler_init();
+    port_enableInterrupts();
+    semaphor_init(&gDone);
+
+    mutexPair = mutexLatency_measurePair(1);
+    semaphorPair = mutexLatency_measurePair(0);
+    printf("{\"name\":\"uncontendedPair\",\"mutexNs\":%.1f,\"semaphorNs\":%.1f}\n", mutexPair, semaphorPair);
+    assert(mutexPair < semaphorPair);
+
+    scheduler_setPriority(scheduler_getRunningThread(), THREAD_PRIORITY_HIGHEST);
+    mutexLatency = mutexLatency_measureInversion(1);
+    semaphorLatency = mutexLatency_measureInversion(0);
+    printf("{\"name\":\"inversion\",\"criticalSection\":%u,\"mutexLatency\":%u,\"semaphorLatency\":%u}\n",
+           MUTEXLATENCY_CRITICAL_SECTION, mutexLatency, semaphorLatency);
+    assert(mutexLatency <= MUTEXLATENCY_CRITICAL_SECTION + 10);     //Bounded by the critical section
+    assert(semaphorLatency >= MUTEXLATENCY_BUSY_TIME);              //The medium priority thread delays the high priority one
+    return 0;
+}
+
+#endif /* __linux__ */
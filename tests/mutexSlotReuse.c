@@ -0,0 +1,80 @@
+/**
+ * mutexSlotReuse.c
+ *
+ * This host test lets a thread terminate while it holds a mutex and starts a new thread, which gets the same slot of the threadpool.
+ * The new thread locks a different mutex and inherits the priority of the main thread, which waits for it. The test checks that the new
+ * thread gets back its own priority after the unlock, so it does not see the mutex count and base priority of the former thread of its slot.
+ *
+ * gcc -O2 -I. scheduler.c semaphor.c mutex.c trace.c port/linux/port.c tests/mutexSlotReuse.c -o mutexSlotReuse
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include "scheduler.h"
+#include "semaphor.h"
+#include "mutex.h"
+
+#define MUTEXSLOTREUSE_STACK_SIZE   16384
+
+static Mutex_t gAbandoned;                              //Locked by the first thread, which terminates without unlocking it
+static Mutex_t gShared;                                 //Locked by the second thread and the main thread
+static Semaphor_t gDone;                                //Released by every thread when it terminates
+static volatile ThreadPriority_t gInherited;            //Priority of the second thread while the main thread waits for it
+static volatile ThreadPriority_t gRestored;             //Priority of the second thread after the unlock
+
+/**
+ * Locks a mutex and terminates while holding it.
+ */
+static void mutexSlotReuse_abandon(void) {
+    mutex_lock(&gAbandoned);
+    semaphor_V(&gDone);
+}
+
+/**
+ * Holds the shared mutex until the main thread waits for it, which raises the priority of this thread, and unlocks it.
+ */
+static void mutexSlotReuse_hold(void) {
+    ThreadID_t id = scheduler_getRunningThread();
+    mutex_lock(&gShared);
+    scheduler_threadSleep(1);                           //The main thread blocks on the mutex meanwhile
+    gInherited = scheduler_getPriority(id);
+    mutex_unlock(&gShared);
+    gRestored = scheduler_getPriority(id);
+    semaphor_V(&gDone);
+}
+
+int main(void) {
+    ThreadID_t first;
+    ThreadID_t second;
+
+    scheduler_init();
+    port_enableInterrupts();
+    mutex_init(&gAbandoned);
+    mutex_init(&gShared);
+    semaphor_init(&gDone);
+
+    first = scheduler_startThread(&mutexSlotReuse_abandon, THREAD_PRIORITY_LOW, MUTEXSLOTREUSE_STACK_SIZE);
+    assert(first != THREAD_ID_INVALID);
+    semaphor_P(&gDone);
+    scheduler_threadSleep(1);                           //The first thread terminates after its semaphor_V
+    assert(gAbandoned.owner == first);
+
+    second = scheduler_startThread(&mutexSlotReuse_hold, THREAD_PRIORITY_LOW, MUTEXSLOTREUSE_STACK_SIZE);
+    assert(second == first);
+    while(gShared.owner != second) {
+        scheduler_threadSleep(1);
+    }
+    mutex_lock(&gShared);
+    mutex_unlock(&gShared);
+    semaphor_P(&gDone);
+
+    printf("{\"name\":\"mutexSlotReuse\",\"slot\":%u,\"inherited\":%u,\"restored\":%u}\n", (unsigned int)second, gInherited, gRestored);
+    assert(gInherited == THREAD_PRIORITY_NORMAL);
+    assert(gRestored == THREAD_PRIORITY_LOW);
+    return 0;
+}
+
+#endif /* __linux__ */
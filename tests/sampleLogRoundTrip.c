@@ -0,0 +1,106 @@
+/**
+ * sampleLogRoundTrip.c
+ *
+ * This host test appends samples to the sample log and reads them back. It checks that the encoding is lossless for the extreme differences
+ * of timestamps and values, that the log keeps the newest samples when the ring overflows, that a recovered log continues its differences and
+ * that a reader skips blocks which have been overwritten while it was reading.
+ *
+ * gcc -O2 -I. scheduler.c semaphor.c mutex.c trace.c sampleLog.c port/linux/port.c tests/sampleLogRoundTrip.c -o sampleLogRoundTrip
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "sampleLog.h"
+
+#define SAMPLELOGROUNDTRIP_SAMPLES  40000                                               //More samples than the log holds
+#define SAMPLELOGROUNDTRIP_CAPACITY (SAMPLELOG_BLOCKS * (SAMPLELOG_BLOCK_SIZE - 6))     //Bytes for samples in the whole log
+
+static SampleLogEntry_t gInput[SAMPLELOGROUNDTRIP_SAMPLES];
+static SampleLogEntry_t gOutput[SAMPLELOGROUNDTRIP_SAMPLES];
+
+/**
+ * Reads the whole log and checks that it holds the newest count samples of the input in order. Returns the number of samples read.
+ */
+static uint16_t sampleLogRoundTrip_check(uint32_t count) {
+    SampleLogReader_t reader;
+    uint16_t read;
+    uint32_t first;
+    uint16_t i;
+
+    sampleLog_openReader(&reader);
+    read = sampleLog_readEntries(&reader, gOutput, SAMPLELOGROUNDTRIP_SAMPLES);
+    assert(read > 0 && read <= count);
+    first = count - read;
+    for(i = 0; i < read; i++) {
+        assert(gOutput[i].timestamp == gInput[first + i].timestamp);
+        assert(gOutput[i].value == gInput[first + i].value);
+    }
+    return read;
+}
+
+int main(void) {
+    static const uint16_t extremes[] = {0, 65535, 0, 32768, 32767, 1, 65534, 65535, 65535, 0};
+    SampleLogReader_t reader;
+    SampleLogEntry_t entry;
+    uint32_t timestamp = 0xFFFFF000UL;                                                  //The timestamps wrap during the test
+    uint16_t value = 26000;
+    uint16_t stored;
+    uint32_t i;
+
+    sampleLog_init();
+    sampleLog_clear();
+    sampleLog_openReader(&reader);
+    assert(sampleLog_read(&reader, &entry) == -1);
+
+    for(i = 0; i < sizeof(extremes) / sizeof(extremes[0]); i++) {                      //Largest differences of the value and the timestamp
+        gInput[i].timestamp = i & 1 ? timestamp + 0x7FFFFFFFUL * i : timestamp;
+        gInput[i].value = extremes[i];
+        sampleLog_append(gInput[i].timestamp, gInput[i].value);
+    }
+    sampleLogRoundTrip_check(i);
+
+    sampleLog_clear();
+    srand(1);
+    for(i = 0; i < SAMPLELOGROUNDTRIP_SAMPLES; i++) {                                   //Regular samples with small changes and a few jumps
+        timestamp += 100 + rand() % 5;
+        value += rand() % 7 - 3;
+        if(i % 997 == 0) {
+            timestamp += 100000;
+        }
+        if(i % 5000 == 0) {
+            value = rand();
+        }
+        gInput[i].timestamp = timestamp;
+        gInput[i].value = value;
+        sampleLog_append(timestamp, value);
+    }
+    stored = sampleLogRoundTrip_check(SAMPLELOGROUNDTRIP_SAMPLES);
+    printf("{\"name\":\"sampleLog\",\"samples\":%u,\"stored\":%u,\"bytesPerSample\":%.2f}\n",
+           SAMPLELOGROUNDTRIP_SAMPLES, stored, (double)SAMPLELOGROUNDTRIP_CAPACITY / stored);
+    assert(stored * 3 >= SAMPLELOGROUNDTRIP_CAPACITY);                                  //At most 3 instead of 6 bytes per sample
+    assert(stored * 2 < SAMPLELOGROUNDTRIP_CAPACITY);                                   //The oldest samples have been overwritten
+
+    sampleLog_openReader(&reader);                                                      //A recovered log continues the differences of its head block
+    while(sampleLog_read(&reader, &entry) == 0);
+    sampleLog_init();
+    sampleLog_append(timestamp + 100, value + 1);
+    assert(sampleLog_read(&reader, &entry) == 0);
+    assert(entry.timestamp == timestamp + 100 && entry.value == (uint16_t)(value + 1));
+    assert(sampleLog_read(&reader, &entry) == -1);
+
+    sampleLog_openReader(&reader);                                                      //A reader of an overwritten block starts over at the oldest one
+    assert(sampleLog_read(&reader, &entry) == 0);
+    timestamp += 200;
+    for(i = 0; i < SAMPLELOGROUNDTRIP_SAMPLES; i++) {
+        sampleLog_append(timestamp + i * 100, 5);
+    }
+    assert(sampleLog_read(&reader, &entry) == 0);
+    assert(entry.value == 5 && (int32_t)(entry.timestamp - timestamp) >= 0);
+    return 0;
+}
+
+#endif /* __linux__ */
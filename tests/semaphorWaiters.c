@@ -0,0 +1,173 @@
+/**
+ * semaphorWaiters.c
+ *
+ * This host stress test blocks 63 threads on a single semaphor. It checks that a FIFO semaphor releases them in the order they blocked,
+ * that an ordered semaphor releases them by priority and in FIFO order within a priority, and that no release gets lost while waiters
+ * with timeouts leave and enter the wait list all the time.
+ *
+ * gcc -O2 -DTHREADPOOL_SIZE=64 -I. scheduler.c semaphor.c mutex.c trace.c port/linux/port.c tests/semaphorWaiters.c -o semaphorWaiters
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include "scheduler.h"
+#include "semaphor.h"
+
+#define SEMAPHORWAITERS_THREADS     (THREADPOOL_SIZE - 1)   //Every slot except the one of the main thread
+#define SEMAPHORWAITERS_ROUNDS      20                      //Number of times every waiter is released by the FIFO test
+#define SEMAPHORWAITERS_RELEASES    20000                   //Number of releases of the timeout test
+#define SEMAPHORWAITERS_STACK_SIZE  16384
+
+static Semaphor_t gSemaphor;                                //The semaphor all threads wait for
+static Semaphor_t gDone;                                    //Released by every thread when it terminates
+static ThreadID_t gIds[SEMAPHORWAITERS_THREADS];            //ThreadIDs in the order the threads have been started
+static ThreadID_t gOrder[SEMAPHORWAITERS_THREADS * SEMAPHORWAITERS_ROUNDS];    //ThreadIDs in the order the threads have taken the semaphor
+static volatile unsigned int gTaken = 0;                    //Number of times the semaphor has been taken
+static volatile unsigned char gStop = 0;                    //Terminates the threads of the timeout test
+
+/**
+ * Takes the semaphor SEMAPHORWAITERS_ROUNDS times and records itself every time.
+ */
+static void semaphorWaiters_fifoThread(void) {
+    unsigned int round;
+    for(round = 0; round < SEMAPHORWAITERS_ROUNDS; round++) {
+        semaphor_P(&gSemaphor);
+        gOrder[gTaken++] = scheduler_getRunningThread();
+    }
+    semaphor_V(&gDone);
+}
+
+/**
+ * Takes the semaphor once and records itself.
+ */
+static void semaphorWaiters_priorityThread(void) {
+    semaphor_P(&gSemaphor);
+    gOrder[gTaken++] = scheduler_getRunningThread();
+    semaphor_V(&gDone);
+}
+
+/**
+ * Waits with a short timeout until the test is stopped and counts every successful wait.
+ */
+static void semaphorWaiters_timeoutThread(void) {
+    uint16_t timeout = 1 + scheduler_getRunningThread() % 3;
+    while(!gStop) {
+        if(semaphor_timedP(&gSemaphor, timeout) == 0) {
+            unsigned short s;
+            ATOMIC_START(s);
+            gTaken++;
+            ATOMIC_END(s);
+        }
+    }
+    semaphor_V(&gDone);
+}
+
+/**
+ * Starts every thread with the specified function. Threads of a higher priority than the main thread run until they block right away.
+ */
+static void semaphorWaiters_start(ThreadFunction_t function, unsigned char byPriority) {
+    unsigned int i;
+    gTaken = 0;
+    for(i = 0; i < SEMAPHORWAITERS_THREADS; i++) {
+        ThreadPriority_t priority = byPriority ? (ThreadPriority_t)(THREAD_PRIORITY_HIGH + i % 3) : THREAD_PRIORITY_HIGH;
+        gIds[i] = scheduler_startThread(function, priority, SEMAPHORWAITERS_STACK_SIZE);
+        assert(gIds[i] != THREAD_ID_INVALID);
+    }
+}
+
+/**
+ * Waits until every thread has terminated.
+ */
+static void semaphorWaiters_join(void) {
+    unsigned int i;
+    for(i = 0; i < SEMAPHORWAITERS_THREADS; i++) {
+        semaphor_P(&gDone);
+    }
+}
+
+/**
+ * Every release makes one waiter run, which blocks again at the end of the wait list, so the waiters are released round robin.
+ */
+static void semaphorWaiters_testFifo(void) {
+    unsigned int i;
+    semaphor_init(&gSemaphor);
+    semaphorWaiters_start(&semaphorWaiters_fifoThread, 0);
+    for(i = 0; i < SEMAPHORWAITERS_THREADS * SEMAPHORWAITERS_ROUNDS; i++) {
+        semaphor_V(&gSemaphor);
+        assert(gTaken == i + 1);
+        assert(gOrder[i] == gIds[i % SEMAPHORWAITERS_THREADS]);
+    }
+    semaphorWaiters_join();
+}
+
+/**
+ * The threads have three different priorities. The main thread blocks until all of them wait, so every release picks from the full wait list.
+ */
+static void semaphorWaiters_testPriority(void) {
+    unsigned short s;
+    unsigned int i;
+    unsigned int expected = 0;
+    int priority;
+
+    semaphor_initOrdered(&gSemaphor, THREADQUEUE_PRIORITY);
+    semaphorWaiters_start(&semaphorWaiters_priorityThread, 1);
+    ATOMIC_START(s);
+    for(i = 0; i < SEMAPHORWAITERS_THREADS; i++) {
+        semaphor_V(&gSemaphor);                             //The releases take effect at the end of the atomic section
+    }
+    ATOMIC_END(s);
+    semaphorWaiters_join();
+    assert(gTaken == SEMAPHORWAITERS_THREADS);
+    for(priority = THREAD_PRIORITY_HIGH + 2; priority >= THREAD_PRIORITY_HIGH; priority--) {
+        for(i = 0; i < SEMAPHORWAITERS_THREADS; i++) {
+            ThreadPriority_t threadPriority = (ThreadPriority_t)(THREAD_PRIORITY_HIGH + i % 3);    //Priority the thread has been started with
+            if(threadPriority == priority) {
+                assert(gOrder[expected++] == gIds[i]);
+            }
+        }
+    }
+}
+
+/**
+ * Releases the semaphor while the waiters time out and wait again all the time. Afterwards every release has either been taken by a waiter
+ * or is still counted by the semaphor.
+ */
+static void semaphorWaiters_testTimeout(void) {
+    unsigned int i;
+    unsigned int remaining = 0;
+
+    semaphor_init(&gSemaphor);
+    gStop = 0;
+    semaphorWaiters_start(&semaphorWaiters_timeoutThread, 0);
+    for(i = 0; i < SEMAPHORWAITERS_RELEASES; i++) {
+        semaphor_V(&gSemaphor);
+        if(i % 100 == 0) {
+            scheduler_threadSleep(1);
+        }
+    }
+    gStop = 1;
+    semaphorWaiters_join();
+    while(semaphor_tryP(&gSemaphor) == 0) {
+        remaining++;
+    }
+    printf("{\"name\":\"timeout\",\"releases\":%u,\"taken\":%u,\"remaining\":%u}\n", SEMAPHORWAITERS_RELEASES, gTaken, remaining);
+    assert(gTaken + remaining == SEMAPHORWAITERS_RELEASES);
+}
+
+int main(void) {
+    scheduler_init();
+    port_enableInterrupts();
+    semaphor_init(&gDone);
+
+    semaphorWaiters_testFifo();
+    printf("{\"name\":\"fifo\",\"waiters\":%u,\"releases\":%u}\n", SEMAPHORWAITERS_THREADS, gTaken);
+    semaphorWaiters_testPriority();
+    printf("{\"name\":\"priority\",\"waiters\":%u,\"releases\":%u}\n", SEMAPHORWAITERS_THREADS, gTaken);
+    semaphorWaiters_testTimeout();
+    return 0;
+}
+
+#endif /* __linux__ */
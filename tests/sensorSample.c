@@ -0,0 +1,117 @@
+/**
+ * sensorSample.c
+ *
+ * This host test runs the double buffer of the sensorDriver with the Linux port. A writer thread of high priority wakes up every system tick,
+ * which preempts the reader thread at an arbitrary instruction, publishes one sample and starts the next one, which goes into the slot the
+ * reader may still be copying. It sleeps in the middle of writing that slot, so the reader continues with a half written slot before the
+ * sample is published. The test checks that no copy mixes the value of one sample with the timestamp of another one.
+ * The sensorDriver is included with fake I2C and launchpad headers, whose functions produce numbered samples.
+ *
+ * gcc -O2 -Isim -I. scheduler.c semaphor.c mutex.c trace.c port/linux/port.c tests/sensorSample.c -o sensorSample
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include "scheduler.h"
+#include "semaphor.h"
+
+#define LAUNCHPAD_H_                                    //Replaces "launchpad.h" and "i2cDriver.h" of the drivers with the fakes below
+#define DRIVERS_I2CDRIVER_H_
+
+typedef enum {
+    I2C_OK = 0
+} I2CStatus_t;
+
+typedef struct {
+    uint8_t address;
+    const uint8_t* txBuf;
+    size_t txLen;
+    uint8_t* rxBuf;
+    size_t rxLen;
+} I2CTransfer_t;
+
+I2CStatus_t i2cDriver_transfer(I2CTransfer_t* transfer);
+uint32_t launchpad_getSystemTicks(void);
+
+#include "../drivers/sensorDriver.c"
+
+#define SENSORSAMPLE_CYCLES         1000                //Number of times the writer preempts the reader
+#define SENSORSAMPLE_STACK_SIZE     16384
+
+static uint16_t gNumber = 0;                            //Number of the sample being written, which is its timestamp and a quarter of its value
+static volatile int gSleepWhileWriting = 0;             //Set while the writer writes a sample into the slot of the reader
+static volatile int gDone = 0;
+static unsigned long gReads = 0;
+static unsigned long gTornReads = 0;
+static Semaphor_t gFinished;
+
+/**
+ * Returns the next result of the SHT21 with a valid checksum, whose value is the number of the sample.
+ */
+I2CStatus_t i2cDriver_transfer(I2CTransfer_t* transfer) {
+    uint16_t value = (uint16_t)(++gNumber << 2);
+    transfer->rxBuf[0] = value >> 8;
+    transfer->rxBuf[1] = value & 0xFF;
+    transfer->rxBuf[2] = sensorDriver_crc(transfer->rxBuf, 2);
+    return I2C_OK;
+}
+
+/**
+ * Returns the number of the sample as its timestamp. It is called between writing the value and the timestamp into the slot,
+ * so this is where the writer gives the reader a chance to run.
+ */
+uint32_t launchpad_getSystemTicks(void) {
+    if(gSleepWhileWriting) {
+        scheduler_threadSleep(1);
+    }
+    return gNumber;
+}
+
+static void sensorSample_writer(void) {
+    int16_t sensorValue;
+    unsigned int i;
+    for(i = 0; i < SENSORSAMPLE_CYCLES; i++) {
+        scheduler_threadSleep(1);                       //The reader runs until the writer wakes up
+        gSleepWhileWriting = 0;
+        assert(sensorDriver_readTemperature(&sensorValue) == I2C_OK);
+        gSleepWhileWriting = 1;
+        assert(sensorDriver_readTemperature(&sensorValue) == I2C_OK);
+    }
+    gDone = 1;
+    semaphor_V(&gFinished);
+}
+
+static void sensorSample_reader(void) {
+    TemperatureSample_t sample;
+    while(!gDone) {
+        sensorDriver_getLatestSample(&sample);
+        if((uint16_t)(sample.timestamp << 2) != sample.value) {
+            gTornReads++;
+        }
+        gReads++;
+    }
+    semaphor_V(&gFinished);
+}
+
+int main(void) {
+    scheduler_init();
+    port_enableInterrupts();
+    semaphor_init(&gFinished);
+    scheduler_setPriority(scheduler_getRunningThread(), THREAD_PRIORITY_HIGHEST);
+
+    assert(scheduler_startThread(&sensorSample_reader, THREAD_PRIORITY_LOW, SENSORSAMPLE_STACK_SIZE) != THREAD_ID_INVALID);
+    assert(scheduler_startThread(&sensorSample_writer, THREAD_PRIORITY_HIGH, SENSORSAMPLE_STACK_SIZE) != THREAD_ID_INVALID);
+    semaphor_P(&gFinished);
+    semaphor_P(&gFinished);
+
+    printf("{\"name\":\"sensorSample\",\"samples\":%u,\"reads\":%lu,\"tornReads\":%lu}\n", gSampleSequence, gReads, gTornReads);
+    assert(gSampleSequence == 2 * SENSORSAMPLE_CYCLES);
+    assert(gReads > SENSORSAMPLE_CYCLES);
+    assert(gTornReads == 0);
+    return 0;
+}
+
+#endif /* __linux__ */
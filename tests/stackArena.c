@@ -0,0 +1,87 @@
+/**
+ * stackArena.c
+ *
+ * This host test checks that the stacks of terminated threads are returned to the stack arena. Threads with growing stacks are started and
+ * terminated over and over, some of them while others with different sizes are still running, so the arena gets fragmented. Afterwards
+ * a single thread has to get a stack of the whole arena.
+ *
+ * gcc -O2 -I. scheduler.c mutex.c trace.c port/linux/port.c tests/stackArena.c -o stackArena
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include "scheduler.h"
+
+#define STACKARENA_MINIMUM      16384                   //Smallest stack of the test, the C library needs a lot of stack on the host
+#define STACKARENA_STEP         PORT_STACK_ALIGNMENT    //Growth of the stack from one thread to the next one
+
+static volatile unsigned int gFinished = 0;             //Number of threads that have been running
+
+/**
+ * Touches the top of its stack and terminates.
+ */
+static void stackArena_thread(void) {
+    volatile uint8_t buffer[256];
+    buffer[0] = 1;
+    buffer[sizeof(buffer) - 1] = buffer[0];
+    gFinished++;
+}
+
+/**
+ * Blocks until the main thread resumes it, so its stack stays assigned meanwhile.
+ */
+static void stackArena_blockingThread(void) {
+    scheduler_blockThread(scheduler_getRunningThread());
+    gFinished++;
+}
+
+/**
+ * Starts a thread above the priority of the main thread, so it has terminated when this returns.
+ */
+static void stackArena_run(size_t stackSize) {
+    unsigned int finished = gFinished;
+    ThreadID_t id = scheduler_startThread(&stackArena_thread, THREAD_PRIORITY_HIGH, stackSize);
+    assert(id != THREAD_ID_INVALID);
+    assert(gFinished == finished + 1);
+}
+
+int main(void) {
+    unsigned short s;
+    size_t stackSize;
+    unsigned int i;
+    unsigned int runs = 0;
+
+    scheduler_init();
+    port_enableInterrupts();
+
+    for(stackSize = PORT_STACK_ARENA_SIZE / 2; stackSize <= PORT_STACK_ARENA_SIZE / 2 + 1000 * STACKARENA_STEP; stackSize += STACKARENA_STEP) {
+        stackArena_run(stackSize);                      //Every thread needs a larger stack than the slot it reuses
+        runs++;
+    }
+
+    for(i = 0; i < 200; i++) {
+        ThreadID_t blocked[3];
+        unsigned int j;
+        for(j = 0; j < 3; j++) {
+            blocked[j] = scheduler_startThread(&stackArena_blockingThread, THREAD_PRIORITY_HIGH, STACKARENA_MINIMUM * (1 + (i + j) % 5));
+            assert(blocked[j] != THREAD_ID_INVALID);
+        }
+        stackArena_run(STACKARENA_MINIMUM * (1 + i % 7));
+        ATOMIC_START(s);
+        for(j = 0; j < 3; j++) {
+            scheduler_resumeThread(blocked[(i + j) % 3]);   //Terminate them in a different order than they were started
+        }
+        ATOMIC_END(s);
+        runs += 4;
+    }
+    assert(gFinished == runs);
+
+    stackArena_run(PORT_STACK_ARENA_SIZE);              //Every stack has been returned, so the whole arena is free again
+    printf("{\"threads\":%u,\"arenaSize\":%lu}\n", runs + 1, (unsigned long)PORT_STACK_ARENA_SIZE);
+    return 0;
+}
+
+#endif /* __linux__ */
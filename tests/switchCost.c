@@ -0,0 +1,95 @@
+/**
+ * switchCost.c
+ *
+ * This host test measures the cost of a switch between threads of the same priority with 5 to 32 ready threads. The ready bitmap picks
+ * the next thread in constant time, so the cost must not grow with the number of threads. Build it with the Linux port and a threadpool,
+ * which holds 32 threads and the main thread:
+ *
+ * gcc -O2 -DTHREADPOOL_SIZE=33 -I. scheduler.c semaphor.c mutex.c trace.c port/linux/port.c tests/switchCost.c -o switchCost
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include "scheduler.h"
+#include "semaphor.h"
+
+#define SWITCHCOST_SWITCHES     200000                  //Number of switches of every measurement
+#define SWITCHCOST_RUNS         5                       //Number of measurements per thread count, the fastest one is used
+#define SWITCHCOST_STACK_SIZE   16384                   //Stack size of every thread
+
+static volatile long gRemaining;                        //Switches the running measurement still has to do
+static Semaphor_t gDone;                                //Released by every thread when the measurement is finished
+
+/**
+ * Returns the nanoseconds of the monotonic clock.
+ */
+static uint64_t switchCost_getTime(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Switches to the next thread of the same priority until the measurement is finished.
+ */
+static void switchCost_thread(void) {
+    while(gRemaining > 0) {
+        gRemaining--;
+        scheduler_runNextThread();
+    }
+    semaphor_V(&gDone);
+}
+
+/**
+ * Starts the threads above the priority of the main thread and returns the nanoseconds per switch, once every thread is finished.
+ */
+static double switchCost_measure(unsigned int threads) {
+    unsigned short s;
+    unsigned int i;
+    uint64_t start;
+
+    gRemaining = SWITCHCOST_SWITCHES;
+    semaphor_init(&gDone);
+    ATOMIC_START(s);
+    for(i = 0; i < threads; i++) {
+        ThreadID_t id = scheduler_startThread(&switchCost_thread, THREAD_PRIORITY_HIGH, SWITCHCOST_STACK_SIZE);
+        assert(id != THREAD_ID_INVALID);
+    }
+    start = switchCost_getTime();
+    ATOMIC_END(s);
+    for(i = 0; i < threads; i++) {
+        semaphor_P(&gDone);
+    }
+    return (double)(switchCost_getTime() - start) / SWITCHCOST_SWITCHES;
+}
+
+/**
+ * Measures every thread count and checks that 32 threads do not cost noticeably more per switch than 5 threads.
+ */
+int main(void) {
+    static const unsigned int counts[] = {5, 8, 16, 32};
+    double costs[sizeof(counts) / sizeof(counts[0])];
+    unsigned int i;
+    unsigned int run;
+
+    scheduler_init();
+    port_enableInterrupts();
+    for(i = 0; i < sizeof(counts) / sizeof(counts[0]); i++) {
+        costs[i] = 0;
+        for(run = 0; run < SWITCHCOST_RUNS; run++) {
+            double cost = switchCost_measure(counts[i]);
+            if(run == 0 || cost < costs[i]) {
+                costs[i] = cost;
+            }
+        }
+        printf("{\"threads\":%u,\"nsPerSwitch\":%.1f}\n", counts[i], costs[i]);
+    }
+    assert(costs[3] < 1.5 * costs[0]);
+    return 0;
+}
+
+#endif /* __linux__ */
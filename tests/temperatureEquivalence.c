@@ -0,0 +1,122 @@
+/**
+ * temperatureEquivalence.c
+ *
+ * This host test compares the temperatureConverter with the former arithmetic of showTempThread and the displayDriver, which used 32 bit
+ * divisions and a remainder per digit. Every 16 bit sensor value is converted in both units and every temperature is converted into digits,
+ * the digits have to be the same. Both conversions are also timed over all sensor values.
+ *
+ * gcc -O2 -DLAUNCHPAD_SIMULATOR -Isim -Idrivers -I. drivers/temperatureConverter.c tests/temperatureEquivalence.c -o temperatureEquivalence
+ *
+ */
+
+#if defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+#include "temperatureConverter.h"
+
+#define TEMPERATUREEQUIVALENCE_RUNS   20                                          //Number of timed runs, the fastest one is used
+
+/**
+ * Converts a temperature into digits like the former displayDriver, digit by digit with the remainder of a division by 10.
+ */
+static void temperatureEquivalence_referenceDigits(int32_t temperature, TemperatureDigits_t* digits) {
+    unsigned int i;
+    digits->negative = temperature < 0;
+    digits->bcd = 0;
+    if(temperature < 0) {
+        temperature = -temperature;
+    }
+    for(i = 0; i < 16; i += 4) {
+        digits->bcd |= (uint16_t)(temperature % 10) << i;
+        temperature /= 10;
+    }
+}
+
+/**
+ * Converts a sensor value like the former showTempThread.
+ */
+static void temperatureEquivalence_reference(uint16_t sensorValue, TemperatureUnit_t unit, TemperatureDigits_t* digits) {
+    volatile int32_t divisor = 10;                                              //Keeps the compiler from replacing the divisions by 10
+    int32_t temperature = sensorValue;
+    temperature *= 17572;
+    temperature /= 65536;
+    temperature -= 4685;
+    temperature /= divisor;
+    if(unit == FAHRENHEIT) {
+        temperature *= 18;
+        temperature /= divisor;
+        temperature += 320;
+    }
+    temperatureEquivalence_referenceDigits(temperature, digits);
+}
+
+/**
+ * Returns the nanoseconds of the monotonic clock.
+ */
+static uint64_t temperatureEquivalence_getTime(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Converts every sensor value in both units with the specified conversion and returns the nanoseconds per conversion of the fastest run.
+ */
+static double temperatureEquivalence_measure(void (*convert)(uint16_t, TemperatureUnit_t, TemperatureDigits_t*), uint32_t* checksum) {
+    double best = 0;
+    unsigned int run;
+    for(run = 0; run < TEMPERATUREEQUIVALENCE_RUNS; run++) {
+        uint64_t start = temperatureEquivalence_getTime();
+        uint32_t value;
+        double cost;
+        for(value = 0; value <= 0xFFFF; value++) {
+            TemperatureDigits_t digits;
+            convert((uint16_t)value, CELSIUS, &digits);
+            *checksum += digits.bcd + digits.negative;
+            convert((uint16_t)value, FAHRENHEIT, &digits);
+            *checksum += digits.bcd + digits.negative;
+        }
+        cost = (double)(temperatureEquivalence_getTime() - start) / (2 * 0x10000);
+        if(run == 0 || cost < best) {
+            best = cost;
+        }
+    }
+    return best;
+}
+
+int main(void) {
+    uint32_t value;
+    int32_t temperature;
+    uint32_t checksum = 0;
+    uint32_t referenceChecksum = 0;
+    double cost;
+    double referenceCost;
+
+    for(value = 0; value <= 0xFFFF; value++) {                                  //Every sensor value in both units
+        TemperatureDigits_t digits;
+        TemperatureDigits_t expected;
+        temperatureConverter_toDigits((uint16_t)value, CELSIUS, &digits);
+        temperatureEquivalence_reference((uint16_t)value, CELSIUS, &expected);
+        assert(digits.bcd == expected.bcd && digits.negative == expected.negative);
+        temperatureConverter_toDigits((uint16_t)value, FAHRENHEIT, &digits);
+        temperatureEquivalence_reference((uint16_t)value, FAHRENHEIT, &expected);
+        assert(digits.bcd == expected.bcd && digits.negative == expected.negative);
+    }
+    for(temperature = INT16_MIN; temperature <= INT16_MAX; temperature++) {     //Every temperature, only the lowest 4 digits are kept
+        TemperatureDigits_t digits;
+        TemperatureDigits_t expected;
+        temperatureConverter_fromTemperature((Temperature_t)temperature, &digits);
+        temperatureEquivalence_referenceDigits(temperature, &expected);
+        assert(digits.bcd == expected.bcd && digits.negative == expected.negative);
+    }
+
+    cost = temperatureEquivalence_measure(&temperatureConverter_toDigits, &checksum);
+    referenceCost = temperatureEquivalence_measure(&temperatureEquivalence_reference, &referenceChecksum);
+    printf("{\"name\":\"temperatureConverter\",\"values\":65536,\"converterNs\":%.2f,\"referenceNs\":%.2f}\n", cost, referenceCost);
+    assert(checksum == referenceChecksum);
+    return 0;
+}
+
+#endif /* LAUNCHPAD_SIMULATOR */
@@ -0,0 +1,97 @@
+/**
+ * workQueue.c
+ *
+ * This host test stresses the work queue with two producer threads, which submit faster than two workers can execute, so the queue runs
+ * full and rejects items. It checks that every accepted item is executed exactly once, that the statistics add up and that the workers
+ * take batches, and it prints the submission cost in cycles of the port.
+ *
+ * gcc -O2 -I. scheduler.c semaphor.c mutex.c trace.c workQueue.c port/linux/port.c tests/workQueue.c -o workQueue
+ *
+ */
+
+#if defined(__linux__) && !defined(LAUNCHPAD_SIMULATOR)
+
+#include <assert.h>
+#include <stdio.h>
+#include "scheduler.h"
+#include "workQueue.h"
+
+#define WORKQUEUE_ITEMS         20000                   //Number of items of every producer
+#define WORKQUEUE_PRODUCERS     2
+#define WORKQUEUE_WORKERS       2
+#define WORKQUEUE_YIELD         (3 * WORKQUEUE_CAPACITY)    //A producer yields after this many items, so the queue runs full in between
+#define WORKQUEUE_STACK_SIZE    16384
+
+static unsigned char gExecutions[WORKQUEUE_PRODUCERS * WORKQUEUE_ITEMS];    //Number of executions of every item
+static volatile unsigned long gExecuted;
+static volatile unsigned long gRejected;                //Rejections seen by the producers, which submit the item again
+static volatile unsigned int gProducer;                 //Index of the next producer that starts
+
+/**
+ * Counts the execution of the item, whose index is the argument.
+ */
+static void workQueue_job(void* argument) {
+    gExecutions[(uintptr_t)argument]++;
+    gExecuted++;
+}
+
+/**
+ * Submits the items of one producer. A rejected item is submitted again after the workers had a chance to run.
+ */
+static void workQueue_producer(void) {
+    uintptr_t first = gProducer++ * WORKQUEUE_ITEMS;
+    uintptr_t i;
+    for(i = first; i < first + WORKQUEUE_ITEMS; i++) {
+        while(workQueue_submit(&workQueue_job, (void*)i) != 0) {
+            gRejected++;
+            scheduler_runNextThread();
+        }
+        if(i % WORKQUEUE_YIELD == 0) {
+            scheduler_runNextThread();
+        }
+    }
+}
+
+int main(void) {
+    WorkQueueStatistics_t statistics;
+    unsigned int i;
+
+    scheduler_init();
+    workQueue_init();
+    port_enableInterrupts();
+    scheduler_setPriority(scheduler_getRunningThread(), THREAD_PRIORITY_HIGHEST);
+
+    for(i = 0; i < WORKQUEUE_WORKERS; i++) {
+        assert(scheduler_startThread(&workQueue_runWorker, THREAD_PRIORITY_NORMAL, WORKQUEUE_STACK_SIZE) != THREAD_ID_INVALID);
+    }
+    for(i = 0; i < WORKQUEUE_PRODUCERS; i++) {
+        assert(scheduler_startThread(&workQueue_producer, THREAD_PRIORITY_NORMAL, WORKQUEUE_STACK_SIZE) != THREAD_ID_INVALID);
+    }
+    while(gExecuted < WORKQUEUE_PRODUCERS * WORKQUEUE_ITEMS) {
+        scheduler_threadSleep(1);
+    }
+
+    for(i = 0; i < WORKQUEUE_PRODUCERS * WORKQUEUE_ITEMS; i++) {
+        assert(gExecutions[i] == 1);
+    }
+    workQueue_getStatistics(&statistics);
+    printf("{\"name\":\"workQueue\",\"submitted\":%lu,\"executed\":%lu,\"rejected\":%u,\"peakDepth\":%u,\"batches\":%lu,\"meanBatch\":%.2f}\n",
+           (unsigned long)statistics.submitted, (unsigned long)statistics.executed, statistics.rejected, statistics.peakDepth,
+           (unsigned long)statistics.batches, (double)statistics.executed / statistics.batches);
+    assert(statistics.submitted == WORKQUEUE_PRODUCERS * WORKQUEUE_ITEMS);
+    assert(statistics.executed == statistics.submitted);
+    assert(statistics.rejected == (uint16_t)gRejected && gRejected > 0);  //The producers outpace the workers at least once
+    assert(statistics.peakDepth == WORKQUEUE_CAPACITY);
+    assert(statistics.batches * WORKQUEUE_BATCH >= statistics.executed);
+    assert(statistics.batches < statistics.executed);                   //The workers take more than one item at once
+
+#if WORKQUEUE_STATISTICS
+    printf("{\"name\":\"submit\",\"meanCycles\":%.1f,\"maxCycles\":%lu,\"frequency\":%lu}\n",
+           (double)statistics.submitCyclesTotal / statistics.submitted, (unsigned long)statistics.submitCyclesMax, (unsigned long)PORT_CYCLE_FREQUENCY);
+    assert(statistics.submitCyclesTotal > 0);
+    assert(statistics.submitCyclesMax >= statistics.submitCyclesTotal / statistics.submitted);
+#endif
+    return 0;
+}
+
+#endif /* __linux__ */
@@ -11,13 +11,45 @@
 #define THREAD_H_
 
 #include <inttypes.h>
-#include <setjmp.h>
+#include "port/port.h"
 
 #define THREAD_ID_INVALID   0xFFFF              //Defines an invalid thread ID
 
+#define THREAD_PRIORITY_LEVELS  8               //Defines the number of priority levels. Must not exceed the width of the ready bitmap in the scheduler (8 bit)
+#define THREAD_PRIORITY_LOWEST  0               //Defines the lowest priority a thread can have
+#define THREAD_PRIORITY_LOW     1               //Defines a low priority for background threads
+#define THREAD_PRIORITY_NORMAL  3               //Defines the default priority, which is also assigned to the main thread
+#define THREAD_PRIORITY_HIGH    5               //Defines a high priority for time critical threads
+#define THREAD_PRIORITY_HIGHEST (THREAD_PRIORITY_LEVELS - 1)    //Defines the highest priority a thread can have
+
+#ifndef THREAD_STATISTICS
+#define THREAD_STATISTICS       1               //Enables the runtime statistics of every thread. Define as 0 to remove them completely
+#endif
+
 typedef uint16_t ThreadID_t;                    //Defines the type and range of ThreadIDs
+typedef uint8_t ThreadPriority_t;               //Defines the priority of a thread. A higher value means a higher priority
 typedef void (*ThreadFunction_t)(void);         //Defines the function pointers to a function that will be executed in a thread
 
+typedef enum {                                  //Defines in which order threads are taken from a ThreadQueue_t
+    THREADQUEUE_FIFO,
+    THREADQUEUE_PRIORITY
+} ThreadQueueOrder_t;
+
+typedef struct {                                //Defines a queue of threads, which is linked through the threads themselves
+    ThreadID_t head;
+    ThreadID_t tail;
+    ThreadQueueOrder_t order;
+} ThreadQueue_t;
+
+typedef struct {                                //Defines the runtime statistics of a thread. Times are measured in timestamps of the port, counters may overflow
+    uint32_t runTime;                           //Accumulated time the thread was running, without the time spent in low power mode
+    uint16_t voluntarySwitches;                 //Number of switches to a different thread, because the thread was sleeping, blocked or terminated
+    uint16_t preemptions;                       //Number of switches to a different thread, although the thread was still ready to run
+    uint16_t wakeups;                           //Number of times the thread was running again after it had been resumed
+    uint16_t wakeLatencyMax;                    //Longest time from being resumed until running again
+    uint32_t wakeLatencyTotal;                  //Accumulated time from being resumed until running again
+} ThreadStatistics_t;
+
 typedef enum {                                  //Defines which states a thread can have
     THREADSTATE_INVALID = -1,
     THREADSTATE_READY,
@@ -30,8 +62,20 @@ typedef enum {                                  //Defines which states a thread
 typedef struct Thread {                         //Defines the control block of a thread
     ThreadFunction_t function;
     ThreadState_t state;
-    uint16_t sleepTime;
-    jmp_buf context;
+    ThreadPriority_t priority;
+    uint16_t timeSlice;                         //System ticks the thread may run before a ready thread of the same priority takes over
+    ThreadID_t next;                            //Links the thread to the next one in the same queue (ready queue, wait queue or list of free slots)
+    ThreadID_t sleepNext;                       //Links the thread to the next one in the sleep queue
+    uint32_t wakeTime;                          //Absolute system tick at which a sleeping thread is woken up
+    ThreadQueue_t* waitQueue;                   //Queue of a wait with timeout, which is left when the timeout expires. NULL otherwise
+    uint8_t* stack;                             //Lowest address of the stack of the thread, which is carved from the stack arena
+    size_t stackSize;                           //Size of the stack in bytes
+#if THREAD_STATISTICS
+    ThreadStatistics_t statistics;
+    uint32_t resumeTime;                        //Timestamp at which the thread was resumed
+    unsigned char resumed;                      //Set while the thread has been resumed but is not running yet
+#endif
+    PortContext_t context;
 } Thread_t;
 
 #endif /* THREAD_H_ */
@@ -0,0 +1,165 @@
+/**
+ * telemetryDecoder.c
+ *
+ * This file implements a host program, which decodes the telemetry stream of the backchannel UART (see drivers/telemetry.h) and writes every frame
+ * as one JSON object per line. Text frames are joined and written line by line. The stream is read from a serial port, the pseudo-terminal of the simulator or a file. A serial port is switched
+ * to raw mode with UART_BAUDRATE. Damaged frames and gaps of the sequence numbers are reported on stderr.
+ *
+ *  gcc -O2 -I. tools/telemetryDecoder.c -o telemetryDecoder
+ *  ./telemetryDecoder /dev/ttyACM1
+ *
+ */
+
+#if defined(__linux__)                                              //Host program, which is not part of the launchpad project
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include "../drivers/telemetry.h"
+
+#define FRAME_SIZE          (TELEMETRY_MAX_PAYLOAD + TELEMETRY_OVERHEAD)    //Maximum size of a frame
+
+static uint8_t gFrame[FRAME_SIZE];                                  //Bytes of the frame received so far, starting with the sync byte
+static unsigned int gLength = 0;                                    //Number of bytes in gFrame
+static int gSequence = -1;                                          //Expected sequence number of the next frame, -1 before the first one
+static unsigned long gDamaged = 0;
+static unsigned long gLost = 0;
+static char gText[256];                                             //Characters of the text line received so far
+static unsigned int gTextLength = 0;
+
+/**
+ * Continues the CRC-8 of the stream over the specified bytes.
+ */
+static uint8_t crc8(uint8_t crc, const uint8_t* data, unsigned int length) {
+    while(length-- > 0) {
+        unsigned int bit;
+        crc ^= *data++;
+        for(bit = 0; bit < 8; bit++) {
+            crc = crc & 0x80 ? (uint8_t)((crc << 1) ^ TELEMETRY_CRC_POLYNOMIAL) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * Reads a little endian value of a payload.
+ */
+static uint32_t readValue(const uint8_t* data, unsigned int size) {
+    uint32_t value = 0;
+    while(size-- > 0) {
+        value = (value << 8) | data[size];
+    }
+    return value;
+}
+
+/**
+ * Writes a complete and valid frame.
+ */
+static void writeFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint8_t sequence) {
+    if(gSequence >= 0 && sequence != gSequence) {
+        gLost += (uint8_t)(sequence - gSequence);
+        fprintf(stderr, "%u frames lost before sequence %u\n", (uint8_t)(sequence - gSequence), sequence);
+        gTextLength = 0;                                            //A text line with a gap is incomplete
+    }
+    gSequence = (uint8_t)(sequence + 1);
+
+    if(type == TELEMETRY_TYPE_SAMPLE && length == 6) {
+        printf("{\"sequence\":%u,\"type\":\"sample\",\"timestamp\":%lu,\"value\":%lu}\n", sequence,
+               (unsigned long)readValue(&payload[0], 4), (unsigned long)readValue(&payload[4], 2));
+    } else if(type == TELEMETRY_TYPE_TRACE && length == 8) {
+        printf("{\"sequence\":%u,\"type\":\"trace\",\"count\":%lu,\"epoch\":%lu,\"event\":%u,\"thread\":%u,\"argument\":%lu}\n", sequence,
+               (unsigned long)readValue(&payload[0], 2), (unsigned long)readValue(&payload[2], 2), payload[4], payload[5], (unsigned long)readValue(&payload[6], 2));
+    } else if(type == TELEMETRY_TYPE_POWER && length == 12) {
+        printf("{\"sequence\":%u,\"type\":\"power\",\"activeTime\":%lu,\"lpm0Time\":%lu,\"lpm3Time\":%lu}\n", sequence,
+               (unsigned long)readValue(&payload[0], 4), (unsigned long)readValue(&payload[4], 4), (unsigned long)readValue(&payload[8], 4));
+    } else if(type == TELEMETRY_TYPE_TEXT) {                        //A text line is written as it is, the kernel benchmark sends JSON objects
+        unsigned int i;
+        for(i = 0; i < length; i++) {
+            if(payload[i] == '\n' || gTextLength == sizeof(gText)) {
+                printf("%.*s\n", (int)gTextLength, gText);
+                gTextLength = 0;
+            }
+            if(payload[i] != '\n') {
+                gText[gTextLength++] = (char)payload[i];
+            }
+        }
+    } else {
+        unsigned int i;
+        printf("{\"sequence\":%u,\"type\":%u,\"payload\":\"", sequence, type);
+        for(i = 0; i < length; i++) {
+            printf("%02X", payload[i]);
+        }
+        printf("\"}\n");
+    }
+    fflush(stdout);
+}
+
+/**
+ * Appends a byte to the current frame. A frame, which is too long or whose CRC does not match, is dropped and the search for the next sync byte
+ * starts right after its own sync byte, so a sync byte within a damaged frame is found as well.
+ */
+static void receive(uint8_t byte) {
+    unsigned int start;
+
+    gFrame[gLength++] = byte;
+    while(gLength > 0) {
+        if(gFrame[0] != TELEMETRY_SYNC) {
+            start = 1;
+        } else if(gLength >= 3 && gFrame[2] > TELEMETRY_MAX_PAYLOAD) {
+            gDamaged++;
+            start = 1;
+        } else if(gLength < 3 || gLength < (unsigned int)gFrame[2] + TELEMETRY_OVERHEAD) {
+            return;                                                 //The frame is not complete yet
+        } else if(crc8(0xFF, &gFrame[1], gLength - 2) != gFrame[gLength - 1]) {
+            gDamaged++;
+            fprintf(stderr, "damaged frame\n");
+            start = 1;
+        } else {
+            writeFrame(gFrame[1], &gFrame[3], gFrame[2], gFrame[gLength - 2]);
+            start = gLength;
+        }
+        for(gLength -= start; gLength > 0 && gFrame[start] != TELEMETRY_SYNC; start++, gLength--);
+        memmove(gFrame, &gFrame[start], gLength);
+    }
+}
+
+/**
+ * Opens the stream, configures a terminal and decodes until the end of the stream.
+ */
+int main(int argc, char* argv[]) {
+    uint8_t buffer[256];
+    ssize_t length;
+    int file;
+
+    if(argc != 2) {
+        fprintf(stderr, "usage: %s <serial port, pseudo-terminal or file>\n", argv[0]);
+        return 1;
+    }
+    file = open(argv[1], O_RDONLY | O_NOCTTY);
+    if(file < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    if(isatty(file)) {
+        struct termios settings;
+        tcgetattr(file, &settings);
+        cfmakeraw(&settings);
+        cfsetispeed(&settings, B115200);                            //UART_BAUDRATE
+        cfsetospeed(&settings, B115200);
+        tcsetattr(file, TCSANOW, &settings);
+    }
+    while((length = read(file, buffer, sizeof(buffer))) > 0) {
+        ssize_t i;
+        for(i = 0; i < length; i++) {
+            receive(buffer[i]);
+        }
+    }
+    close(file);
+    fprintf(stderr, "%lu frames lost, %lu damaged\n", gLost, gDamaged);
+    return 0;
+}
+
+#endif /* __linux__ */
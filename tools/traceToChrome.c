@@ -0,0 +1,236 @@
+/**
+ * traceToChrome.c
+ *
+ * This file implements a host program, which converts a binary dump of the trace ring buffer gTrace into the Chrome trace format.
+ * The output is opened with chrome://tracing or https://ui.perfetto.dev and shows the running thread, the idle time and the interrupts
+ * as slices and every other event of the trace as instant events. The records of every boot follow each other on the same timeline.
+ *
+ *  gcc -O2 -I. tools/traceToChrome.c -o traceToChrome
+ *  ./traceToChrome trace.bin > trace.json
+ *
+ */
+
+#if defined(__linux__)                                              //Host program, which is not part of the launchpad project
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "../trace.h"
+
+#define HEADER_SIZE         12                                      //Size of the header of the buffer in a dump, which is the same on every platform
+#define RECORD_SIZE         8                                       //Size of a record in a dump
+#define MAX_RECORDS         4096                                    //Maximum number of records the converter accepts
+#define TID_IDLE            1000                                    //Track of the idle loop
+#define TID_ISR             1001                                    //Track of the first interrupt, the other interrupts follow
+
+static const char* const gEventNames[] = {                          //Names of the events, which are shown in the timeline
+    "switch",
+    "ready",
+    "blocked",
+    "sleeping",
+    "idle",
+    "semaphor_P",
+    "semaphor_V",
+    "isrEnter",
+    "isrExit",
+    "boot"
+};
+
+static const char* const gIsrNames[] = {                            //Names of the traced interrupts
+    "TIMER0_A0",
+    "USCI_B0"
+};
+
+static unsigned char gDump[HEADER_SIZE + MAX_RECORDS * RECORD_SIZE];
+static int gFirst = 1;                                              //Set until the first event has been written
+
+/**
+ * Reads a little endian value of a dump, which is the byte order of the MSP430 and of x86.
+ */
+static uint32_t readValue(const unsigned char* data, unsigned int size) {
+    uint32_t value = 0;
+    while(size-- > 0) {
+        value = (value << 8) | data[size];
+    }
+    return value;
+}
+
+/**
+ * Writes the separator between two events of the array.
+ */
+static void writeSeparator(void) {
+    printf(gFirst ? "\n" : ",\n");
+    gFirst = 0;
+}
+
+/**
+ * Writes a slice event (B or E) of a track.
+ */
+static void writeSlice(char phase, const char* name, int tid, double ts) {
+    writeSeparator();
+    printf("{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":0,\"tid\":%d,\"ts\":%.3f}", name, phase, tid, ts);
+}
+
+/**
+ * Writes the name of a track.
+ */
+static void writeTrackName(int tid, const char* name) {
+    writeSeparator();
+    printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", tid, name);
+}
+
+/**
+ * Returns the name of the slice of a track.
+ */
+static const char* sliceName(int tid) {
+    static char name[24];
+    if(tid == TID_IDLE) {
+        return "idle";
+    }
+    sprintf(name, "thread %d", tid);
+    return name;
+}
+
+/**
+ * Closes the slice of the CPU and of every interrupt, which is still open.
+ */
+static void closeSlices(int* running, int* isrOpen, double ts) {
+    unsigned int i;
+    if(*running >= 0) {
+        writeSlice('E', sliceName(*running), *running, ts);
+        *running = -1;
+    }
+    for(i = 0; i < sizeof(gIsrNames) / sizeof(gIsrNames[0]); i++) {
+        if(isrOpen[i]) {
+            writeSlice('E', gIsrNames[i], TID_ISR + i, ts);
+            isrOpen[i] = 0;
+        }
+    }
+}
+
+/**
+ * Reads the dump, walks the records from the oldest to the latest one and writes the events. The raw timestamps are extended to 64 bit
+ * with the signed difference of consecutive records, so the counter may overflow in between as long as two records are less than half
+ * its range apart. The epoch of a raw timestamp may lag behind a wrap of its count, which makes the difference negative, so 65536 is added
+ * in that case. The timestamps restart at a boot record, which therefore continues the timeline right after the previous record and closes
+ * every open slice. Every slice, which is still open at the end, is closed with the last timestamp.
+ */
+int main(int argc, char* argv[]) {
+    FILE* file;
+    size_t length;
+    unsigned int size, next, count, i, first;
+    uint32_t frequency, previous = 0;
+    int64_t ticks = 0;
+    double ts = 0;
+    int running = -1;                                               //Track of the open slice of the CPU, -1 if none is known yet
+    int isrOpen[sizeof(gIsrNames) / sizeof(gIsrNames[0])] = { 0 };
+    int threadSeen[TRACE_THREAD_NONE] = { 0 };
+
+    if(argc != 2) {
+        fprintf(stderr, "usage: %s <dump of gTrace>\n", argv[0]);
+        return 1;
+    }
+    file = fopen(argv[1], "rb");
+    if(file == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    length = fread(gDump, 1, sizeof(gDump), file);
+    fclose(file);
+
+    if(length < HEADER_SIZE || readValue(&gDump[0], 2) != TRACE_MAGIC) {
+        fprintf(stderr, "%s is no dump of an initialized trace buffer\n", argv[1]);
+        return 1;
+    }
+    size = readValue(&gDump[2], 2);
+    next = readValue(&gDump[4], 2);
+    frequency = readValue(&gDump[8], 4);
+    if(size == 0 || size > MAX_RECORDS || next >= size || frequency == 0 || length < HEADER_SIZE + size * RECORD_SIZE) {
+        fprintf(stderr, "%s has an invalid header or is truncated\n", argv[1]);
+        return 1;
+    }
+    count = readValue(&gDump[6], 2) ? size : next;
+    first = readValue(&gDump[6], 2) ? next : 0;
+
+    printf("{\"traceEvents\":[");
+    for(i = 0; i < count; i++) {
+        const unsigned char* record = &gDump[HEADER_SIZE + ((first + i) % size) * RECORD_SIZE];
+        uint32_t timestamp = readValue(&record[0], 4);
+        unsigned int event = record[4];
+        unsigned int thread = record[5];
+        unsigned int argument = readValue(&record[6], 2);
+
+        if(event == TRACE_EVENT_BOOT) {
+            closeSlices(&running, isrOpen, ts);
+            previous = timestamp;
+        } else if(i > 0) {
+            int32_t difference = (int32_t)(timestamp - previous);
+            if(difference < 0 && difference >= -65536) {            //The epoch of this record or of the previous one lagged behind
+                difference += 65536;
+            }
+            ticks += difference;
+            previous += difference;
+        } else {
+            previous = timestamp;
+        }
+        ts = (double)ticks * 1000000.0 / frequency;
+        if(thread != TRACE_THREAD_NONE && !threadSeen[thread]) {
+            threadSeen[thread] = 1;
+            writeTrackName(thread, sliceName(thread));
+        }
+
+        switch(event) {
+        case TRACE_EVENT_SWITCH:
+        case TRACE_EVENT_IDLE:
+            if(running >= 0) {
+                writeSlice('E', sliceName(running), running, ts);
+            }
+            running = event == TRACE_EVENT_SWITCH ? (int)thread : TID_IDLE;
+            writeSlice('B', sliceName(running), running, ts);
+            break;
+        case TRACE_EVENT_READY:
+        case TRACE_EVENT_BLOCKED:
+        case TRACE_EVENT_SLEEPING:
+            writeSeparator();
+            printf("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"args\":{\"argument\":%u}}",
+                   gEventNames[event], thread, ts, argument);
+            break;
+        case TRACE_EVENT_SEMAPHOR_P:
+        case TRACE_EVENT_SEMAPHOR_V:
+            writeSeparator();
+            printf("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"args\":{\"semaphor\":\"0x%04X\"}}",
+                   gEventNames[event], running >= 0 ? running : TID_IDLE, ts, argument);
+            break;
+        case TRACE_EVENT_ISR_ENTER:
+        case TRACE_EVENT_ISR_EXIT:
+            if(argument >= sizeof(gIsrNames) / sizeof(gIsrNames[0])) {
+                break;
+            }
+            if(event == TRACE_EVENT_ISR_ENTER && !isrOpen[argument]) {
+                isrOpen[argument] = 1;
+                writeSlice('B', gIsrNames[argument], TID_ISR + argument, ts);
+            } else if(event == TRACE_EVENT_ISR_EXIT && isrOpen[argument]) {   //The exit of an interrupt, which entered before the oldest record, is dropped
+                isrOpen[argument] = 0;
+                writeSlice('E', gIsrNames[argument], TID_ISR + argument, ts);
+            }
+            break;
+        case TRACE_EVENT_BOOT:
+            writeSeparator();
+            printf("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":%d,\"ts\":%.3f}", gEventNames[event], TID_IDLE, ts);
+            break;
+        default:
+            fprintf(stderr, "record %u has the unknown event %u\n", i, event);
+            break;
+        }
+    }
+
+    closeSlices(&running, isrOpen, ts);
+    for(i = 0; i < sizeof(gIsrNames) / sizeof(gIsrNames[0]); i++) {
+        writeTrackName(TID_ISR + i, gIsrNames[i]);
+    }
+    writeTrackName(TID_IDLE, "idle");
+    printf("\n]}\n");
+    return 0;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,62 @@
+/**
+ * trace.c
+ *
+ * This file contains the implementation of the functionality declared in trace.h.
+ *
+ */
+
+#include <string.h>
+#include "trace.h"
+
+#if defined(__TI_COMPILER_VERSION__)
+#pragma PERSISTENT(gTrace)                                                  //The buffer is kept in FRAM, which saves RAM and is written without wait states
+#endif
+TraceBuffer_t gTrace = { 0 };                                               //Ring buffer of the trace
+
+/**
+ * Keeps the ring buffer only if its header matches this build, otherwise it is cleared. The boot record marks where the timestamps restart.
+ */
+void trace_init(void) {
+    if(gTrace.magic != TRACE_MAGIC || gTrace.size != TRACE_BUFFER_SIZE || gTrace.next >= TRACE_BUFFER_SIZE || gTrace.frequency != PORT_TIMESTAMP_FREQUENCY) {
+        trace_clear();
+    }
+    trace_record(TRACE_EVENT_BOOT, TRACE_THREAD_NONE, 0);
+}
+
+/**
+ * Clears the ring buffer and writes its header.
+ */
+void trace_clear(void) {
+    unsigned short s;
+    ATOMIC_START(s);
+    memset(gTrace.records, 0, sizeof(gTrace.records));
+    gTrace.size = TRACE_BUFFER_SIZE;
+    gTrace.next = 0;
+    gTrace.wrapped = 0;
+    gTrace.frequency = PORT_TIMESTAMP_FREQUENCY;
+    gTrace.magic = TRACE_MAGIC;
+    ATOMIC_END(s);
+}
+
+/**
+ * Writes a record into the ring buffer. The raw timestamp only reads the timer and its epoch and the index wraps with a mask,
+ * so the whole record takes a few instructions.
+ */
+void trace_record(uint8_t event, uint8_t thread, uint16_t argument) {
+    unsigned short s;
+    TraceRecord_t* record;
+    uint32_t timestamp;
+    ATOMIC_START(s);
+    record = &gTrace.records[gTrace.next];
+    timestamp = port_getRawTimestamp();
+    record->count = (uint16_t)timestamp;
+    record->epoch = (uint16_t)(timestamp >> 16);
+    record->event = event;
+    record->thread = thread;
+    record->argument = argument;
+    gTrace.next = (gTrace.next + 1) & (TRACE_BUFFER_SIZE - 1);
+    if(gTrace.next == 0) {
+        gTrace.wrapped = 1;
+    }
+    ATOMIC_END(s);
+}
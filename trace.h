@@ -0,0 +1,83 @@
+/**
+ * trace.h
+ *
+ * This Headerfile defines the event trace of the kernel. Every trace point writes a record with a raw timestamp of the port into a ring buffer,
+ * which always holds the latest TRACE_BUFFER_SIZE records. The buffer persists across resets, every boot appends a TRACE_EVENT_BOOT record. The buffer is dumped as is, e.g. with the memory view of the debugger,
+ * and converted into the Chrome trace format with "tools/traceToChrome.c" to view the timeline.
+ *
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <inttypes.h>
+#include "port/port.h"
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED           1                       //Enables the trace points of the kernel and the drivers. Define as 0 to remove them completely
+#endif
+
+#define TRACE_BUFFER_SIZE       128                     //Defines the number of records in the ring buffer. Must be a power of two
+#define TRACE_MAGIC             0x5452                  //Identifies a valid trace buffer in a dump
+#define TRACE_THREAD_NONE       0xFF                    //Thread of a record, which belongs to the running thread or to no thread at all
+
+typedef enum {                                          //Defines the events of the trace. The meaning of thread and argument depends on the event
+    TRACE_EVENT_SWITCH,                                 //The thread starts running, the argument is the previous thread
+    TRACE_EVENT_READY,                                  //The thread has been started or resumed
+    TRACE_EVENT_BLOCKED,                                //The thread waits for a resume
+    TRACE_EVENT_SLEEPING,                               //The thread sleeps, the argument is the sleep time in system ticks
+    TRACE_EVENT_IDLE,                                   //No thread is ready, the CPU enters low power mode
+    TRACE_EVENT_SEMAPHOR_P,                             //The running thread takes a semaphor, the argument is the lower 16 bit of its address
+    TRACE_EVENT_SEMAPHOR_V,                             //The running thread or an interrupt releases a semaphor, the argument is the lower 16 bit of its address
+    TRACE_EVENT_ISR_ENTER,                              //An interrupt starts, the argument is a TraceIsr_t
+    TRACE_EVENT_ISR_EXIT,                               //An interrupt ends, the argument is a TraceIsr_t
+    TRACE_EVENT_BOOT                                    //The kernel has been initialized, the timestamps of the following records start again
+} TraceEvent_t;
+
+typedef enum {                                          //Defines the traced interrupts
+    TRACE_ISR_TIMER0_A0,
+    TRACE_ISR_USCI_B0
+} TraceIsr_t;
+
+typedef struct {                                        //Defines a record of the trace with the same layout on every platform
+    uint16_t count;                                     //Lower 16 bit of the raw timestamp of the port, which is the count of TimerA0 on the launchpad
+    uint16_t epoch;                                     //Upper 16 bit of the raw timestamp, which may lag behind a wrap of the count by one
+    uint8_t event;                                      //TraceEvent_t
+    uint8_t thread;
+    uint16_t argument;
+} TraceRecord_t;
+
+typedef struct {                                        //Defines the ring buffer of the trace, which describes itself in a dump
+    uint16_t magic;                                     //TRACE_MAGIC once the buffer has been initialized
+    uint16_t size;                                      //Number of records in the buffer
+    uint16_t next;                                      //Index of the record written next, which is the oldest one after the buffer wrapped
+    uint16_t wrapped;                                   //Set once every record of the buffer has been written
+    uint32_t frequency;                                 //Frequency of the timestamps in Hz
+    TraceRecord_t records[TRACE_BUFFER_SIZE];
+} TraceBuffer_t;
+
+#if TRACE_ENABLED
+#define TRACE(event, thread, argument)  trace_record((event), (thread), (argument))     //Writes a record if the trace is enabled
+#else
+#define TRACE(event, thread, argument)
+#endif
+
+extern TraceBuffer_t gTrace;                            //Ring buffer of the trace, which is dumped for the conversion
+
+/**
+ * Initializes the ring buffer, unless it already holds a valid trace of a previous boot, and appends a TRACE_EVENT_BOOT record.
+ * So the records that led to a reset can still be dumped after it.
+ */
+void trace_init(void);
+
+/**
+ * Removes every record from the ring buffer.
+ */
+void trace_clear(void);
+
+/**
+ * Writes a record with the current timestamp into the ring buffer and overwrites the oldest one, if the buffer is full. This is an atomic function.
+ */
+void trace_record(uint8_t event, uint8_t thread, uint16_t argument);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,116 @@
+/**
+ * workQueue.c
+ *
+ * This file contains the implementation of the functionality declared in workQueue.h.
+ *
+ */
+
+#include <string.h>
+#include "scheduler.h"
+#include "workQueue.h"
+#include "port/port.h"
+
+static WorkItem_t gItems[WORKQUEUE_CAPACITY];           //Ring buffer of the pending items
+static unsigned int gReadIndex = 0;
+static unsigned int gCount = 0;
+static ThreadQueue_t gWorkerQueue = {THREAD_ID_INVALID, THREAD_ID_INVALID, THREADQUEUE_FIFO};   //Queue of the workers, while the work queue is empty
+static WorkQueueStatistics_t gStatistics;
+
+/**
+ * Initializes the empty work queue. Workers, which already wait, keep waiting for the first item.
+ */
+void workQueue_init(void) {
+    unsigned short s;
+    ATOMIC_START(s);
+    gReadIndex = 0;
+    gCount = 0;
+    memset(&gStatistics, 0, sizeof(gStatistics));
+    ATOMIC_END(s);
+}
+
+/**
+ * Appends an item to the ring buffer. Only a single worker is resumed, because it takes up to WORKQUEUE_BATCH items at once. The duration
+ * is measured with the cycle counter up to the end of the atomic section, which includes the resume of the worker. A submission takes far less
+ * than a wrap of the counter, so the difference cast to PortCycles_t is exact.
+ */
+int workQueue_submit(WorkFunction_t function, void* argument) {
+    unsigned short s;
+    WorkItem_t* item;
+#if WORKQUEUE_STATISTICS
+    PortCycles_t start = port_getCycles();
+    PortCycles_t duration;
+#endif
+
+    ATOMIC_START(s);
+    if(gCount == WORKQUEUE_CAPACITY) {
+        gStatistics.rejected++;
+        ATOMIC_END(s);
+        return -1;
+    }
+    item = &gItems[(gReadIndex + gCount) & (WORKQUEUE_CAPACITY - 1)];
+    item->function = function;
+    item->argument = argument;
+    gCount++;
+    if(gCount > gStatistics.peakDepth) {
+        gStatistics.peakDepth = gCount;
+    }
+    gStatistics.submitted++;
+    scheduler_resumeQueuedThread(&gWorkerQueue);
+#if WORKQUEUE_STATISTICS
+    duration = (PortCycles_t)(port_getCycles() - start);
+    gStatistics.submitCyclesTotal += duration;
+    if(duration > gStatistics.submitCyclesMax) {
+        gStatistics.submitCyclesMax = duration;
+    }
+#endif
+    ATOMIC_END(s);
+    return 0;
+}
+
+/**
+ * Runs a worker. The worker copies up to WORKQUEUE_BATCH items out of the ring buffer within one atomic section and executes them with
+ * interrupts enabled, so the interrupts are only disabled once per batch. If the queue still holds items afterwards, another waiting worker
+ * is resumed, so the workers share a burst. The worker waits in its queue while the work queue is empty.
+ */
+void workQueue_runWorker(void) {
+    unsigned short s;
+    WorkItem_t batch[WORKQUEUE_BATCH];
+    unsigned int count;
+    unsigned int i;
+
+    ATOMIC_START(s);
+    while(1) {
+        if(gCount == 0) {
+            scheduler_blockThreadInQueue(&gWorkerQueue);
+            continue;
+        }
+        count = gCount < WORKQUEUE_BATCH ? gCount : WORKQUEUE_BATCH;
+        for(i = 0; i < count; i++) {
+            batch[i] = gItems[gReadIndex];
+            gReadIndex = (gReadIndex + 1) & (WORKQUEUE_CAPACITY - 1);
+        }
+        gCount -= count;
+        gStatistics.batches++;
+        if(gCount > 0) {
+            scheduler_resumeQueuedThread(&gWorkerQueue);
+        }
+        ATOMIC_END(s);
+
+        for(i = 0; i < count; i++) {
+            batch[i].function(batch[i].argument);
+        }
+
+        ATOMIC_START(s);
+        gStatistics.executed += count;
+    }
+}
+
+/**
+ * Copies the statistics within an atomic section, so they are consistent.
+ */
+void workQueue_getStatistics(WorkQueueStatistics_t* statistics) {
+    unsigned short s;
+    ATOMIC_START(s);
+    *statistics = gStatistics;
+    ATOMIC_END(s);
+}
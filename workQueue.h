@@ -0,0 +1,63 @@
+/**
+ * workQueue.h
+ *
+ * This Headerfile defines the basic structure and functions of the deferred work queue. Interrupts and threads submit short jobs as a function
+ * and an argument, which the worker threads execute later, so an interrupt only does the urgent part of its work and a short job does not need
+ * a thread with its own stack.
+ *
+ */
+
+#ifndef WORKQUEUE_H_
+#define WORKQUEUE_H_
+
+#include "thread.h"
+
+#define WORKQUEUE_CAPACITY      16                      //Defines the number of items, which can be pending at the same time. Must be a power of two
+#define WORKQUEUE_BATCH         4                       //Defines the maximum number of items a worker takes out of the queue at once
+
+#ifndef WORKQUEUE_STATISTICS
+#define WORKQUEUE_STATISTICS    1                       //Enables the measurement of the submission cost. Define as 0 to remove it completely
+#endif
+
+typedef void (*WorkFunction_t)(void* argument);         //Defines the function pointers to a function that is executed by a worker
+
+typedef struct {                                        //Defines an item of the work queue
+    WorkFunction_t function;
+    void* argument;                                     //Passed to the function
+} WorkItem_t;
+
+typedef struct {                                        //Defines the statistics of the work queue
+    uint32_t submitted;                                 //Items that have been accepted
+    uint32_t executed;                                  //Items that have been executed
+    uint16_t rejected;                                  //Items that have been rejected, because the queue was full
+    uint16_t peakDepth;                                 //Highest number of pending items so far
+    uint32_t batches;                                   //Number of batches the workers have taken, executed / batches is the mean batch size
+#if WORKQUEUE_STATISTICS
+    uint32_t submitCyclesTotal;                         //Sum of the durations of every accepted submission in cycles of the port (PORT_CYCLE_FREQUENCY)
+    uint32_t submitCyclesMax;                           //Longest duration of a submission in cycles of the port
+#endif
+} WorkQueueStatistics_t;
+
+/**
+ * Initializes the empty work queue and resets its statistics.
+ */
+void workQueue_init(void);
+
+/**
+ * Appends an item, which executes the function with the argument, and resumes a waiting worker. Returns 0 on success and -1 if the queue is full,
+ * in which case the item is dropped. This is an atomic function, which never blocks, so it may be called from threads and interrupts.
+ */
+int workQueue_submit(WorkFunction_t function, void* argument);
+
+/**
+ * Runs a worker in the calling thread, which executes the submitted items in their order. Several threads may run a worker, e.g. with different
+ * stack sizes or priorities. This function does not return.
+ */
+void workQueue_runWorker(void);
+
+/**
+ * Copies the statistics of the work queue.
+ */
+void workQueue_getStatistics(WorkQueueStatistics_t* statistics);
+
+#endif /* WORKQUEUE_H_ */